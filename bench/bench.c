@@ -0,0 +1,93 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+//A headless benchmark of the puzzle engine. It drives every game through the
+//same calls the game makes, without opening a window or an audio device, and
+//prints how many clicks with a win check, and how many randomizes, each game
+//does per second.
+//
+//Usage: bench [clicks per game] [seed]
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "pocico.h"
+
+//The clicks are drawn before timing, and reused round robin.
+#define BENCH_POSITIONS 4096
+
+static double seconds(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+int main(int argc, char * argv[])
+{
+  long clicks = 10000000;
+  uint64_t seed = 1;
+  if(argc > 1) clicks = strtol(argv[1], NULL, 0);
+  if(argc > 2) seed = strtoull(argv[2], NULL, 0);
+  long randomizes = clicks / 1000 > 10 ? clicks / 1000 : 10;
+
+  seed_games(seed);
+  init_games();
+
+  static int positions[BENCH_POSITIONS];
+  printf("%-6s %8s %16s %16s\n", "uid", "states", "clicks/s", "randomizes/s");
+  for(int g = 0; g < GAME_COUNT; g++)
+  {
+    Game * game = games[g];
+    int n = game_number_of_positions(game);
+    for(int i = 0; i < BENCH_POSITIONS; i++)
+    {
+      do
+      {
+        positions[i] = pcg32_bounded(&game->rng, n);
+      } while(!game_position_has_state(game, positions[i]));
+    }
+
+    //Count the wins so the win checks can't be optimized away.
+    long wins = 0;
+    double start = seconds();
+    for(long i = 0; i < clicks; i++)
+    {
+      game->transform(game, positions[i % BENCH_POSITIONS], game->right_state, 1);
+      if(matching_game(game)) wins++;
+    }
+    double click_time = seconds() - start;
+
+    start = seconds();
+    for(long i = 0; i < randomizes; i++)
+    {
+      game->randomize(game);
+    }
+    double randomize_time = seconds() - start;
+
+    printf("%-6d %8d %16.0f %16.0f%s\n", game->uid, game_number_of_states(game),
+      clicks / click_time, randomizes / randomize_time, wins > 0 ? " (won)" : "");
+  }
+  return 0;
+}
@@ -0,0 +1,324 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "bitboard.h"
+
+//The mask of bits in use in the last word of a board.
+static uint64_t last_word_mask(const Bitboard * const board)
+{
+  int used = board->size - (board->words - 1) * 64;
+  if(used >= 64) return ~(uint64_t)0;
+  return ((uint64_t)1 << used) - 1;
+}
+
+//Return a word with its low bits random. Small boards only need one draw.
+static uint64_t random_word(Pcg32 * rng, const int bits)
+{
+  uint64_t word = pcg32_random(rng);
+  if(bits > 32) word |= (uint64_t)pcg32_random(rng) << 32;
+  return word;
+}
+
+//The number of bits in use in word w of a board.
+static int word_bits(const Bitboard * const board, const int w)
+{
+  int used = board->size - w * 64;
+  return used < 64 ? used : 64;
+}
+
+bool bitboard_init(Bitboard * board, const Game * const game)
+{
+  board->size = 0;
+  board->words = 0;
+  board->positions = NULL;
+  board->masks = NULL;
+  if(game->mod != 2) return false;
+  if(game_number_of_states(game) > BITBOARD_MAX_SIZE) return false;
+
+  const int number_of_positions = game_number_of_positions(game);
+  board->positions = malloc(sizeof(int) * (number_of_positions > 0 ? number_of_positions : 1));
+  for(int i = 0; i < number_of_positions; i++)
+  {
+    if(game_position_has_state(game, i)) board->positions[board->size++] = i;
+  }
+  board->words = (board->size + 63) / 64;
+  if(board->words == 0) board->words = 1;
+  board->masks = calloc((size_t)board->size * board->words, sizeof(uint64_t));
+
+  if(game->transform == transform && game->move_matrix != NULL)
+  {
+    //Every position holds state data here, so bits and positions are the same.
+    for(int bit = 0; bit < board->size; bit++)
+    {
+      uint64_t * mask = board->masks + (size_t)bit * board->words;
+      int index = game->move_matrix_index[bit];
+      int number_of_states_to_modify = game->move_matrix[index];
+      for(int i = index + 1; i < index + 1 + number_of_states_to_modify; i++)
+      {
+        int changed = game->move_matrix[i];
+        mask[changed / 64] ^= (uint64_t)1 << (changed % 64);
+      }
+    }
+  }
+  else
+  {
+    //No explicit move matrix, so click each position once on a zeroed state
+    //and see what changed. Transforms can update the game they are given, so
+    //they get a copy of that.
+    Game copy = *game;
+    uint8_t * scratch = calloc(number_of_positions, sizeof(uint8_t));
+    for(int bit = 0; bit < board->size; bit++)
+    {
+      uint64_t * mask = board->masks + (size_t)bit * board->words;
+      copy.transform(&copy, board->positions[bit], scratch, 1);
+      for(int changed = 0; changed < board->size; changed++)
+      {
+        if(scratch[board->positions[changed]] != 0)
+        {
+          mask[changed / 64] |= (uint64_t)1 << (changed % 64);
+          scratch[board->positions[changed]] = 0;
+        }
+      }
+    }
+    free(scratch);
+  }
+  return true;
+}
+
+void bitboard_free(Bitboard * board)
+{
+  free(board->positions);
+  free(board->masks);
+  board->positions = NULL;
+  board->masks = NULL;
+  board->size = 0;
+  board->words = 0;
+}
+
+//One cached bitboard per game, indexed by uid.
+static Bitboard cached_boards[GAME_COUNT + 1];
+static int cached_shapes[GAME_COUNT + 1];
+static bool cached[GAME_COUNT + 1];
+
+const Bitboard * game_bitboard(const Game * const game)
+{
+  if(game->mod != 2) return NULL;
+  if(game_number_of_states(game) > BITBOARD_MAX_SIZE) return NULL;
+  if(game->uid < 0 || GAME_COUNT < game->uid) return NULL;
+  const int shape = game_shape(game);
+  if(!cached[game->uid] || cached_shapes[game->uid] != shape)
+  {
+    if(cached[game->uid]) bitboard_free(&cached_boards[game->uid]);
+    bitboard_init(&cached_boards[game->uid], game);
+    cached_shapes[game->uid] = shape;
+    cached[game->uid] = true;
+  }
+  return &cached_boards[game->uid];
+}
+
+void bitboard_pack(const Bitboard * const board, const uint8_t * const state, uint64_t * const bits)
+{
+  memset(bits, 0, sizeof(uint64_t) * board->words);
+  for(int bit = 0; bit < board->size; bit++)
+  {
+    if(state[board->positions[bit]] & 1) bits[bit / 64] |= (uint64_t)1 << (bit % 64);
+  }
+}
+
+void bitboard_unpack(const Bitboard * const board, const uint64_t * const bits, uint8_t * const state)
+{
+  for(int bit = 0; bit < board->size; bit++)
+  {
+    state[board->positions[bit]] = (bits[bit / 64] >> (bit % 64)) & 1;
+  }
+}
+
+void bitboard_random(const Bitboard * const board, Pcg32 * rng, uint64_t * const bits)
+{
+  for(int w = 0; w < board->words; w++) bits[w] = random_word(rng, word_bits(board, w));
+  bits[board->words - 1] &= last_word_mask(board);
+}
+
+void bitboard_scramble(const Bitboard * const board, Pcg32 * rng, uint64_t * const bits)
+{
+  for(int w = 0; w < board->words; w++)
+  {
+    uint64_t clicks = random_word(rng, word_bits(board, w));
+    if(w == board->words - 1) clicks &= last_word_mask(board);
+    while(clicks)
+    {
+      bitboard_click(board, bits, w * 64 + __builtin_ctzll(clicks));
+      clicks &= clicks - 1;
+    }
+  }
+}
+
+bool bitboard_solve(
+  const Bitboard * const board,
+  const uint64_t * const left,
+  const uint64_t * const right,
+  uint64_t * const clicks
+)
+{
+  const int size = board->size;
+  const int words = board->words;
+
+  //Row r of the system says which clicks flip bit r, so it is column r of the
+  //masks. The right hand side is which bits differ.
+  uint64_t * rows = calloc((size_t)size * words, sizeof(uint64_t));
+  uint64_t * rhs = malloc(sizeof(uint64_t) * words);
+  int * pivot_bit = malloc(sizeof(int) * (size > 0 ? size : 1));
+  for(int click = 0; click < size; click++)
+  {
+    const uint64_t * mask = board->masks + (size_t)click * words;
+    for(int r = 0; r < size; r++)
+    {
+      if((mask[r / 64] >> (r % 64)) & 1)
+      {
+        rows[(size_t)r * words + click / 64] |= (uint64_t)1 << (click % 64);
+      }
+    }
+  }
+  for(int w = 0; w < words; w++) rhs[w] = left[w] ^ right[w];
+
+  //Gauss-Jordan elimination, so every pivot column ends up with a single bit.
+  int rank = 0;
+  for(int bit = 0; bit < size && rank < size; bit++)
+  {
+    const int word = bit / 64;
+    const uint64_t column = (uint64_t)1 << (bit % 64);
+    int pivot = -1;
+    for(int r = rank; r < size; r++)
+    {
+      if(rows[(size_t)r * words + word] & column)
+      {
+        pivot = r;
+        break;
+      }
+    }
+    if(pivot < 0) continue;
+
+    uint64_t * pivot_row = rows + (size_t)rank * words;
+    if(pivot != rank)
+    {
+      uint64_t * other = rows + (size_t)pivot * words;
+      for(int w = 0; w < words; w++)
+      {
+        uint64_t temp = pivot_row[w];
+        pivot_row[w] = other[w];
+        other[w] = temp;
+      }
+      uint64_t a = (rhs[rank / 64] >> (rank % 64)) & 1;
+      uint64_t b = (rhs[pivot / 64] >> (pivot % 64)) & 1;
+      if(a != b)
+      {
+        rhs[rank / 64] ^= (uint64_t)1 << (rank % 64);
+        rhs[pivot / 64] ^= (uint64_t)1 << (pivot % 64);
+      }
+    }
+
+    const uint64_t pivot_rhs = (rhs[rank / 64] >> (rank % 64)) & 1;
+    for(int r = 0; r < size; r++)
+    {
+      uint64_t * row = rows + (size_t)r * words;
+      if(r != rank && (row[word] & column))
+      {
+        for(int w = 0; w < words; w++) row[w] ^= pivot_row[w];
+        rhs[r / 64] ^= pivot_rhs << (r % 64);
+      }
+    }
+    pivot_bit[rank++] = bit;
+  }
+
+  //Rows past the rank are all zero, so their right hand side has to be too.
+  bool solvable = true;
+  for(int r = rank; r < size; r++)
+  {
+    if((rhs[r / 64] >> (r % 64)) & 1) solvable = false;
+  }
+
+  if(solvable)
+  {
+    //Free variables are 0, so each pivot click is its row's right hand side.
+    memset(clicks, 0, sizeof(uint64_t) * words);
+    for(int r = 0; r < rank; r++)
+    {
+      if((rhs[r / 64] >> (r % 64)) & 1)
+      {
+        clicks[pivot_bit[r] / 64] |= (uint64_t)1 << (pivot_bit[r] % 64);
+      }
+    }
+  }
+
+  free(rows);
+  free(rhs);
+  free(pivot_bit);
+  return solvable;
+}
+
+bool bitboard_randomize(Game * game, const bool check_old_state)
+{
+  const Bitboard * board = game_bitboard(game);
+  if(board == NULL) return false;
+
+  const int words = board->words;
+  uint64_t old_left[words];
+  uint64_t old_right[words];
+  uint64_t left[words];
+  uint64_t right[words];
+  bitboard_pack(board, game->left_state, old_left);
+  bitboard_pack(board, game->right_state, old_right);
+
+  bool won = bitboard_matching(board, old_left, old_right);
+
+  //Randomize the left state, then scramble a copy of it for the right.
+  bitboard_random(board, &game->rng, left);
+  memcpy(right, left, sizeof(uint64_t) * words);
+  bitboard_scramble(board, &game->rng, right);
+
+  //The same rules as randomize, patched up the same way instead of drawing
+  //again. Every click flips at least one bit, so one more click makes the
+  //sides differ, and flipping the same bit on both sides changes them without
+  //making them match.
+  randomize_stats.randomizations++;
+  if(bitboard_matching(board, left, right))
+  {
+    bitboard_click(board, right, pcg32_bounded(&game->rng, board->size));
+    randomize_stats.extra_clicks++;
+  }
+  if( !won && check_old_state &&
+      bitboard_matching(board, left, old_left) && bitboard_matching(board, right, old_right) )
+  {
+    int bit = pcg32_bounded(&game->rng, board->size);
+    left[bit / 64] ^= (uint64_t)1 << (bit % 64);
+    right[bit / 64] ^= (uint64_t)1 << (bit % 64);
+    randomize_stats.repeated_states++;
+  }
+
+  bitboard_unpack(board, left, game->left_state);
+  bitboard_unpack(board, right, game->right_state);
+  game->mismatches = 0;
+  for(int w = 0; w < words; w++) game->mismatches += __builtin_popcountll(left[w] ^ right[w]);
+  return true;
+}
@@ -0,0 +1,97 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+//Bit packed boards for mod 2 games.
+//
+//With mod 2 every state is a single bit and clicking a position flips a fixed
+//set of them, so a board fits in a few 64 bit words and a click is one XOR per
+//word. Positions without state data (the empty parts of a polyform grid) are
+//left out, so a 100 cell polyomino is two words no matter how big its grid is.
+
+#ifndef POCICO_BITBOARD_H
+#define POCICO_BITBOARD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pocico.h"
+
+typedef struct Bitboard {
+  int size; //The number of positions with state data, i.e. the number of bits.
+  int words; //The number of 64 bit words in one board.
+  int * positions; //positions[bit] is the position in the game's state arrays.
+  uint64_t * masks; //size * words. The bits flipped by clicking each bit.
+} Bitboard;
+
+//The click masks take size * size bits, so bigger boards are left to the byte
+//versions of randomize and solve.
+#define BITBOARD_MAX_SIZE 4096
+
+//Build a bitboard for a game's current shape. Returns false, and leaves the
+//bitboard empty, if the game's mod isn't 2 or it has more than
+//BITBOARD_MAX_SIZE states.
+bool bitboard_init(Bitboard * board, const Game * const game);
+void bitboard_free(Bitboard * board);
+
+//The bitboard for a game's current shape, built on first use and rebuilt when
+//game_shape changes. Returns NULL if bitboard_init would fail. The cache is
+//shared, so this isn't thread safe; batch jobs on several threads should use
+//bitboard_init instead.
+const Bitboard * game_bitboard(const Game * const game);
+
+//Convert between a game's state array and a packed board of board->words
+//words. Unpacking only writes positions with state data.
+void bitboard_pack(const Bitboard * const board, const uint8_t * const state, uint64_t * const bits);
+void bitboard_unpack(const Bitboard * const board, const uint64_t * const bits, uint8_t * const state);
+
+//Click one bit, i.e. the position board->positions[bit].
+static inline void bitboard_click(const Bitboard * const board, uint64_t * const bits, const int bit)
+{
+  const uint64_t * mask = board->masks + (size_t)bit * board->words;
+  for(int w = 0; w < board->words; w++) bits[w] ^= mask[w];
+}
+
+static inline bool bitboard_matching(const Bitboard * const board, const uint64_t * const a, const uint64_t * const b)
+{
+  for(int w = 0; w < board->words; w++)
+  {
+    if(a[w] != b[w]) return false;
+  }
+  return true;
+}
+
+//Set every bit of a board at random.
+void bitboard_random(const Bitboard * const board, Pcg32 * rng, uint64_t * const bits);
+
+//Click a random subset of the positions, which for mod 2 is the same as
+//clicking every position a random number of times.
+void bitboard_scramble(const Bitboard * const board, Pcg32 * rng, uint64_t * const bits);
+
+//Find the bits to click to turn right into left by elimination over GF(2).
+//Returns false if there is no solution.
+bool bitboard_solve(const Bitboard * const board, const uint64_t * const left, const uint64_t * const right, uint64_t * const clicks);
+
+//The mod 2 version of randomize. If check_old_state is true the new states are
+//also required to differ from the old ones, like randomize does. Returns false
+//if the game's mod isn't 2 and nothing was done.
+bool bitboard_randomize(Game * game, const bool check_old_state);
+
+#endif
@@ -0,0 +1,516 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <GL/glew.h>
+#include "lattice.h"
+
+//Positions are in pixels from the shape's centre. Distances to a shape are
+//negative inside it, and the edges are antialiased over one pixel.
+static const char * const vertex_shader_source =
+  "#version 330 core\n"
+  "in ivec2 cell;\n"
+  "in uvec4 data;\n"
+  "uniform vec2 viewport;\n"
+  "uniform vec2 origin;\n"
+  "uniform vec2 pitch;\n"
+  "uniform vec2 size;\n"
+  "uniform float pad;\n"
+  "uniform int shape;\n"
+  "flat out uvec3 cell_data;\n"
+  "out vec2 local;\n"
+  "void main()\n"
+  "{\n"
+  "  vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);\n"
+  "  vec2 top_left = origin + vec2(cell) * pitch;\n"
+  "  vec2 centre = top_left + size * 0.5;\n"
+  "  if(shape == 1)\n"
+  "  {\n"
+  "    bool up = (data.z & 1u) != 0u;\n"
+  "    centre = vec2(top_left.x, top_left.y + (up ? size.y * 2.0 / 3.0 : size.y / 3.0));\n"
+  "    top_left.x -= size.x * 0.5;\n"
+  "  }\n"
+  "  vec2 p = top_left - pad + corner * (size + 2.0 * pad);\n"
+  "  local = p - centre;\n"
+  "  cell_data = data.xyz;\n"
+  "  gl_Position = vec4(p.x / viewport.x * 2.0 - 1.0, 1.0 - p.y / viewport.y * 2.0, 0.0, 1.0);\n"
+  "}\n";
+
+static const char * const fragment_shader_source =
+  "#version 330 core\n"
+  "uniform vec3 palette[16];\n" //LATTICE_MAX_COLORS
+  "uniform int shape;\n"
+  "uniform float outer;\n"
+  "uniform float inner;\n"
+  "uniform float outer_stroke;\n"
+  "uniform float inner_stroke;\n"
+  "flat in uvec3 cell_data;\n"
+  "in vec2 local;\n"
+  "out vec4 color;\n"
+  "float distance_to(float radius, bool up)\n"
+  "{\n"
+  "  if(shape == 0) return max(abs(local.x), abs(local.y)) - radius;\n"
+  "  vec2 p = up ? local : vec2(local.x, -local.y);\n"
+  "  float d = max(p.y, max(dot(p, vec2(-0.8660254, -0.5)), dot(p, vec2(0.8660254, -0.5))));\n"
+  "  return d - radius;\n"
+  "}\n"
+  "void main()\n"
+  "{\n"
+  "  bool up = (cell_data.z & 1u) != 0u;\n"
+  "  bool mismatch = (cell_data.z & 2u) != 0u;\n"
+  "  float d_outer = distance_to(outer, up);\n"
+  "  vec3 c = palette[cell_data.x];\n"
+  "  if(mismatch)\n"
+  "  {\n"
+  "    float d_inner = distance_to(inner, up);\n"
+  "    if(d_inner < 0.0) c = palette[cell_data.y];\n"
+  "    c = mix(vec3(1.0), c, clamp(abs(d_inner) - inner_stroke + 0.5, 0.0, 1.0));\n"
+  "  }\n"
+  "  if(outer_stroke > 0.0)\n"
+  "  {\n"
+  "    c = mix(vec3(1.0), c, clamp(abs(d_outer) - outer_stroke + 0.5, 0.0, 1.0));\n"
+  "  }\n"
+  "  color = vec4(c, clamp(0.5 - (d_outer - outer_stroke), 0.0, 1.0));\n"
+  "}\n";
+
+//Draws a quad over the whole board. Each fragment finds its cell the same
+//way the game's hit tests do and looks up both states in a texture.
+static const char * const grid_vertex_shader_source =
+  "#version 330 core\n"
+  "uniform vec2 viewport;\n"
+  "uniform vec4 rect;\n"
+  "out vec2 position;\n"
+  "void main()\n"
+  "{\n"
+  "  vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);\n"
+  "  position = rect.xy + corner * rect.zw;\n"
+  "  gl_Position = vec4(position.x / viewport.x * 2.0 - 1.0, 1.0 - position.y / viewport.y * 2.0, 0.0, 1.0);\n"
+  "}\n";
+
+static const char * const grid_fragment_shader_source =
+  "#version 330 core\n"
+  "uniform usampler2D states;\n"
+  "uniform vec3 palette[16];\n" //LATTICE_MAX_COLORS
+  "uniform int shape;\n"
+  "uniform vec2 origin;\n"
+  "uniform vec2 pitch;\n"
+  "uniform vec2 size;\n"
+  "uniform float inner_scale;\n"
+  "uniform bool first_up;\n"
+  "in vec2 position;\n"
+  "out vec4 color;\n"
+  "float distance_to(vec2 local, float radius, bool up)\n"
+  "{\n"
+  "  if(shape == 0) return max(abs(local.x), abs(local.y)) - radius;\n"
+  "  vec2 p = up ? local : vec2(local.x, -local.y);\n"
+  "  float d = max(p.y, max(dot(p, vec2(-0.8660254, -0.5)), dot(p, vec2(0.8660254, -0.5))));\n"
+  "  return d - radius;\n"
+  "}\n"
+  "void main()\n"
+  "{\n"
+  "  vec2 p = position - origin;\n"
+  "  ivec2 cell;\n"
+  "  vec2 local;\n"
+  "  bool up = false;\n"
+  "  float radius = size.x * 0.5;\n"
+  "  if(shape == 0)\n"
+  "  {\n"
+  "    cell = ivec2(floor(p / pitch));\n"
+  "    local = p - vec2(cell) * pitch - size * 0.5;\n"
+  "  }\n"
+  "  else\n"
+  "  {\n"
+  "    float u = p.x / pitch.x;\n"
+  "    float v = p.y / pitch.y;\n"
+  "    int r = int(floor(v));\n"
+  "    int c = int(floor(u));\n"
+  "    v -= float(r);\n"
+  "    up = ((r + c) & 1) != 0 ? !first_up : first_up;\n"
+  "    if((up ? v : 1.0 - v) < u - float(c))\n"
+  "    {\n"
+  "      c++;\n"
+  "      up = !up;\n"
+  "    }\n"
+  "    cell = ivec2(c, r);\n"
+  "    local = p - vec2(float(c) * pitch.x, float(r) * pitch.y + (up ? size.y * 2.0 / 3.0 : size.y / 3.0));\n"
+  "    radius = size.y / 3.0;\n"
+  "  }\n"
+  "  if(any(lessThan(cell, ivec2(0))) || any(greaterThanEqual(cell, textureSize(states, 0)))) discard;\n"
+  "  uvec2 state = texelFetch(states, cell, 0).rg;\n"
+  "  if(state.r == 255u || distance_to(local, radius, up) > 0.0) discard;\n"
+  "  vec3 c = palette[state.r];\n"
+  "  if(state.r != state.g && distance_to(local, radius * inner_scale, up) < 0.0) c = palette[state.g];\n"
+  "  color = vec4(c, 1.0);\n"
+  "}\n";
+
+//Texels of the state texture: the outer state, then the inner one.
+//LATTICE_NO_CELL marks positions that aren't part of the board.
+#define LATTICE_NO_CELL 255
+
+typedef struct Lattice_Renderer {
+  bool available;
+  GLuint program;
+  GLuint vertex_array;
+  GLuint buffer;
+  int buffer_capacity; //Instances the GL buffer has room for.
+  Lattice_Instance * instances;
+  int capacity;
+  GLint viewport;
+  GLint origin;
+  GLint pitch;
+  GLint size;
+  GLint pad;
+  GLint shape;
+  GLint palette;
+  GLint outer;
+  GLint inner;
+  GLint outer_stroke;
+  GLint inner_stroke;
+  //lattice_draw_grid.
+  GLuint grid_program;
+  GLuint grid_vertex_array; //Empty, core contexts need one bound to draw.
+  GLuint grid_texture;
+  int grid_rows;
+  int grid_cols;
+  //The board the texture holds. The cells array tells games apart, and shape
+  //tells one game's shapes apart even when their arrays share an address.
+  const uint8_t * grid_cells;
+  int grid_generation;
+  uint8_t * grid_texels; //Room to pack the texels being uploaded.
+  GLint grid_viewport;
+  GLint grid_rect;
+  GLint grid_states;
+  GLint grid_palette;
+  GLint grid_shape;
+  GLint grid_origin;
+  GLint grid_pitch;
+  GLint grid_size;
+  GLint grid_inner_scale;
+  GLint grid_first_up;
+} Lattice_Renderer;
+
+static Lattice_Renderer lattice;
+
+//nanovg leaves its own state behind, so set everything a draw relies on.
+//viewport_height is needed since OpenGL counts scissor rows from the bottom.
+static void set_draw_state(const Lattice_Layout * const layout, const int viewport_height)
+{
+  glDisable(GL_STENCIL_TEST);
+  glDisable(GL_DEPTH_TEST);
+  glDisable(GL_CULL_FACE);
+  glDisable(GL_SCISSOR_TEST);
+  glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+  if(layout->clip_width > 0.0f)
+  {
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(
+      (GLint) layout->clip_x,
+      (GLint) (viewport_height - layout->clip_y - layout->clip_height),
+      (GLsizei) layout->clip_width,
+      (GLsizei) layout->clip_height);
+  }
+}
+
+static GLuint compile_shader(GLenum type, const char * source)
+{
+  GLuint shader = glCreateShader(type);
+  glShaderSource(shader, 1, &source, NULL);
+  glCompileShader(shader);
+  GLint compiled = GL_FALSE;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+  if(!compiled)
+  {
+    char log[1024];
+    glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+    printf("Warning: lattice shader didn't compile! %s\n", log);
+    glDeleteShader(shader);
+    return 0;
+  }
+  return shader;
+}
+
+//Return the linked program, or 0 if it didn't compile or link.
+static GLuint link_program(const char * vertex_source, const char * fragment_source)
+{
+  GLuint vertex_shader = compile_shader(GL_VERTEX_SHADER, vertex_source);
+  GLuint fragment_shader = compile_shader(GL_FRAGMENT_SHADER, fragment_source);
+  if(vertex_shader == 0 || fragment_shader == 0)
+  {
+    glDeleteShader(vertex_shader);
+    glDeleteShader(fragment_shader);
+    return 0;
+  }
+  GLuint program = glCreateProgram();
+  glAttachShader(program, vertex_shader);
+  glAttachShader(program, fragment_shader);
+  glBindAttribLocation(program, 0, "cell");
+  glBindAttribLocation(program, 1, "data");
+  glLinkProgram(program);
+  glDeleteShader(vertex_shader);
+  glDeleteShader(fragment_shader);
+  GLint linked = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  if(!linked)
+  {
+    char log[1024];
+    glGetProgramInfoLog(program, sizeof(log), NULL, log);
+    printf("Warning: lattice shaders didn't link! %s\n", log);
+    glDeleteProgram(program);
+    return 0;
+  }
+  return program;
+}
+
+bool lattice_init(void)
+{
+  if(!GLEW_VERSION_3_3) return false;
+
+  lattice.program = link_program(vertex_shader_source, fragment_shader_source);
+  lattice.grid_program = link_program(grid_vertex_shader_source, grid_fragment_shader_source);
+  if(lattice.program == 0 || lattice.grid_program == 0)
+  {
+    glDeleteProgram(lattice.program);
+    glDeleteProgram(lattice.grid_program);
+    lattice.program = 0;
+    lattice.grid_program = 0;
+    return false;
+  }
+
+  lattice.viewport = glGetUniformLocation(lattice.program, "viewport");
+  lattice.origin = glGetUniformLocation(lattice.program, "origin");
+  lattice.pitch = glGetUniformLocation(lattice.program, "pitch");
+  lattice.size = glGetUniformLocation(lattice.program, "size");
+  lattice.pad = glGetUniformLocation(lattice.program, "pad");
+  lattice.shape = glGetUniformLocation(lattice.program, "shape");
+  lattice.palette = glGetUniformLocation(lattice.program, "palette");
+  lattice.outer = glGetUniformLocation(lattice.program, "outer");
+  lattice.inner = glGetUniformLocation(lattice.program, "inner");
+  lattice.outer_stroke = glGetUniformLocation(lattice.program, "outer_stroke");
+  lattice.inner_stroke = glGetUniformLocation(lattice.program, "inner_stroke");
+
+  //The corners of each cell's quad come from gl_VertexID, so the only
+  //attributes are the per instance ones.
+  glGenVertexArrays(1, &lattice.vertex_array);
+  glGenBuffers(1, &lattice.buffer);
+  glBindVertexArray(lattice.vertex_array);
+  glBindBuffer(GL_ARRAY_BUFFER, lattice.buffer);
+  glEnableVertexAttribArray(0);
+  glVertexAttribIPointer(0, 2, GL_SHORT, sizeof(Lattice_Instance), (void *) offsetof(Lattice_Instance, col));
+  glVertexAttribDivisor(0, 1);
+  glEnableVertexAttribArray(1);
+  glVertexAttribIPointer(1, 4, GL_UNSIGNED_BYTE, sizeof(Lattice_Instance), (void *) offsetof(Lattice_Instance, outer));
+  glVertexAttribDivisor(1, 1);
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  lattice.grid_viewport = glGetUniformLocation(lattice.grid_program, "viewport");
+  lattice.grid_rect = glGetUniformLocation(lattice.grid_program, "rect");
+  lattice.grid_states = glGetUniformLocation(lattice.grid_program, "states");
+  lattice.grid_palette = glGetUniformLocation(lattice.grid_program, "palette");
+  lattice.grid_shape = glGetUniformLocation(lattice.grid_program, "shape");
+  lattice.grid_origin = glGetUniformLocation(lattice.grid_program, "origin");
+  lattice.grid_pitch = glGetUniformLocation(lattice.grid_program, "pitch");
+  lattice.grid_size = glGetUniformLocation(lattice.grid_program, "size");
+  lattice.grid_inner_scale = glGetUniformLocation(lattice.grid_program, "inner_scale");
+  lattice.grid_first_up = glGetUniformLocation(lattice.grid_program, "first_up");
+  glGenVertexArrays(1, &lattice.grid_vertex_array);
+  glGenTextures(1, &lattice.grid_texture);
+
+  lattice.available = true;
+  return true;
+}
+
+bool lattice_available(void)
+{
+  return lattice.available;
+}
+
+Lattice_Instance * lattice_instances(const int count)
+{
+  if(lattice.capacity < count)
+  {
+    Lattice_Instance * instances = realloc(lattice.instances, count * sizeof(Lattice_Instance));
+    if(instances == NULL) return NULL;
+    lattice.instances = instances;
+    lattice.capacity = count;
+  }
+  return lattice.instances;
+}
+
+void lattice_draw(const Lattice_Layout * const layout, const int count, const float * const palette, const int colors)
+{
+  if(!lattice.available || count <= 0) return;
+
+  //Orphan the buffer every frame so the upload never waits on the GPU still
+  //drawing the last one.
+  glBindBuffer(GL_ARRAY_BUFFER, lattice.buffer);
+  if(lattice.buffer_capacity < count)
+  {
+    lattice.buffer_capacity = count;
+  }
+  glBufferData(GL_ARRAY_BUFFER, lattice.buffer_capacity * sizeof(Lattice_Instance), NULL, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(Lattice_Instance), lattice.instances);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  GLint viewport[4];
+  glGetIntegerv(GL_VIEWPORT, viewport);
+
+  float radius = layout->shape == LATTICE_SQUARES ? layout->width * 0.5f : layout->height / 3.0f;
+  glUseProgram(lattice.program);
+  glUniform2f(lattice.viewport, viewport[2], viewport[3]);
+  glUniform2f(lattice.origin, layout->x, layout->y);
+  glUniform2f(lattice.pitch, layout->pitch_x, layout->pitch_y);
+  glUniform2f(lattice.size, layout->width, layout->height);
+  glUniform1f(lattice.pad, layout->outer_stroke * 0.5f + 1.0f);
+  glUniform1i(lattice.shape, layout->shape);
+  glUniform3fv(lattice.palette, colors < LATTICE_MAX_COLORS ? colors : LATTICE_MAX_COLORS, palette);
+  glUniform1f(lattice.outer, radius);
+  glUniform1f(lattice.inner, radius * layout->inner_scale);
+  glUniform1f(lattice.outer_stroke, layout->outer_stroke * 0.5f);
+  glUniform1f(lattice.inner_stroke, layout->inner_stroke * 0.5f);
+
+  set_draw_state(layout, viewport[3]);
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+  glBindVertexArray(lattice.vertex_array);
+  glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count);
+  glBindVertexArray(0);
+  glUseProgram(0);
+  glDisable(GL_SCISSOR_TEST);
+}
+//Bring the state texture up to date with the grids, only uploading the
+//rectangle that changed unless the board is a different one.
+static void update_grid_texture(const int rows, const int cols, const uint8_t * const outer, const uint8_t * const inner, const uint8_t * const cells, const int shape, Lattice_Rect changed)
+{
+  glBindTexture(GL_TEXTURE_2D, lattice.grid_texture);
+  if(lattice.grid_rows != rows || lattice.grid_cols != cols || lattice.grid_cells != cells || lattice.grid_generation != shape || lattice.grid_texels == NULL)
+  {
+    uint8_t * texels = realloc(lattice.grid_texels, 2 * rows * cols);
+    if(texels == NULL) return;
+    lattice.grid_texels = texels;
+    if(lattice.grid_rows != rows || lattice.grid_cols != cols)
+    {
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RG8UI, cols, rows, 0, GL_RG_INTEGER, GL_UNSIGNED_BYTE, NULL);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+    lattice.grid_rows = rows;
+    lattice.grid_cols = cols;
+    lattice.grid_cells = cells;
+    lattice.grid_generation = shape;
+    changed = (Lattice_Rect){0, 0, rows, cols};
+  }
+
+  //Keep the rectangle inside the board.
+  if(changed.row < 0)
+  {
+    changed.rows += changed.row;
+    changed.row = 0;
+  }
+  if(changed.col < 0)
+  {
+    changed.cols += changed.col;
+    changed.col = 0;
+  }
+  if(changed.row + changed.rows > rows) changed.rows = rows - changed.row;
+  if(changed.col + changed.cols > cols) changed.cols = cols - changed.col;
+  if(changed.rows < 1 || changed.cols < 1) return;
+
+  uint8_t * texel = lattice.grid_texels;
+  for(int r = changed.row; r < changed.row + changed.rows; r++)
+  {
+    for(int c = changed.col; c < changed.col + changed.cols; c++)
+    {
+      int index = r * cols + c;
+      *texel++ = cells[index] ? outer[index] : LATTICE_NO_CELL;
+      *texel++ = cells[index] ? inner[index] : LATTICE_NO_CELL;
+    }
+  }
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, changed.col, changed.row, changed.cols, changed.rows, GL_RG_INTEGER, GL_UNSIGNED_BYTE, lattice.grid_texels);
+  //nanovg expects the default.
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+void lattice_draw_grid(const Lattice_Layout * const layout, const int rows, const int cols, const uint8_t * const outer, const uint8_t * const inner, const uint8_t * const cells, const int shape, const Lattice_Rect changed, const bool first_triangle_facing, const float * const palette, const int colors)
+{
+  if(!lattice.available || rows <= 0 || cols <= 0) return;
+
+  glActiveTexture(GL_TEXTURE0);
+  update_grid_texture(rows, cols, outer, inner, cells, shape, changed);
+
+  GLint viewport[4];
+  glGetIntegerv(GL_VIEWPORT, viewport);
+
+  glUseProgram(lattice.grid_program);
+  glUniform2f(lattice.grid_viewport, viewport[2], viewport[3]);
+  if(layout->shape == LATTICE_SQUARES)
+  {
+    glUniform4f(lattice.grid_rect, layout->x, layout->y, cols * layout->pitch_x, rows * layout->pitch_y);
+  }
+  else
+  {
+    //Triangle c is centred on x + c * pitch_x and reaches half its width to
+    //either side.
+    glUniform4f(lattice.grid_rect, layout->x - layout->width * 0.5f, layout->y, (cols - 1) * layout->pitch_x + layout->width, rows * layout->pitch_y);
+  }
+  glUniform1i(lattice.grid_states, 0);
+  glUniform3fv(lattice.grid_palette, colors < LATTICE_MAX_COLORS ? colors : LATTICE_MAX_COLORS, palette);
+  glUniform1i(lattice.grid_shape, layout->shape);
+  glUniform2f(lattice.grid_origin, layout->x, layout->y);
+  glUniform2f(lattice.grid_pitch, layout->pitch_x, layout->pitch_y);
+  glUniform2f(lattice.grid_size, layout->width, layout->height);
+  glUniform1f(lattice.grid_inner_scale, layout->inner_scale);
+  glUniform1i(lattice.grid_first_up, first_triangle_facing);
+
+  set_draw_state(layout, viewport[3]);
+  glDisable(GL_BLEND);
+
+  glBindVertexArray(lattice.grid_vertex_array);
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+  glBindVertexArray(0);
+  glUseProgram(0);
+  glDisable(GL_SCISSOR_TEST);
+  //nanovg keeps track of the texture it last bound, which is none outside of
+  //its own calls.
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void lattice_delete(void)
+{
+  if(lattice.available)
+  {
+    glDeleteProgram(lattice.program);
+    glDeleteVertexArrays(1, &lattice.vertex_array);
+    glDeleteBuffers(1, &lattice.buffer);
+    glDeleteProgram(lattice.grid_program);
+    glDeleteVertexArrays(1, &lattice.grid_vertex_array);
+    glDeleteTextures(1, &lattice.grid_texture);
+  }
+  free(lattice.instances);
+  free(lattice.grid_texels);
+  lattice = (Lattice_Renderer){0};
+}
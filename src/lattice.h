@@ -0,0 +1,115 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+//Draws the polyomino and polyiamond boards straight with OpenGL 3.3, without
+//going through nanovg. Every cell is one instance holding its grid position,
+//its two states and a couple of flags. The whole board is drawn with a single
+//instanced call, and the shader works out the outer shape, the inner shape
+//and the white stroke around mismatched cells.
+//
+//Once cells are only a few pixels big, even that is wasted work, so the board
+//can also be drawn as a single quad over a texture holding both state grids.
+//Only the rectangle of cells the caller says changed is uploaded, and the cost
+//of drawing no longer depends on the number of cells.
+
+#ifndef POCICO_LATTICE_H
+#define POCICO_LATTICE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+enum LATTICE_SHAPE {LATTICE_SQUARES, LATTICE_TRIANGLES};
+
+//Instance flags.
+#define LATTICE_FACING_UP 1 //Triangles only.
+#define LATTICE_MISMATCH 2 //The inner state is drawn, with a stroke.
+
+typedef struct Lattice_Instance {
+  int16_t col;
+  int16_t row;
+  uint8_t outer; //Index into the palette.
+  uint8_t inner;
+  uint8_t flags;
+  uint8_t unused;
+} Lattice_Instance;
+
+//Where and how big the cells are, in pixels. Cell (row, col) starts at
+//(x + col * pitch_x, y + row * pitch_y). A square is width wide and tall.
+//A triangle is centred on that x and width wide, with its top at that y, and
+//height tall.
+typedef struct Lattice_Layout {
+  enum LATTICE_SHAPE shape;
+  float x;
+  float y;
+  float pitch_x;
+  float pitch_y;
+  float width;
+  float height;
+  float inner_scale; //The size of the inner shape relative to the outer one.
+  float outer_stroke; //Stroke widths, 0 for none.
+  float inner_stroke;
+  //Nothing is drawn outside this rectangle, unless clip_width is 0.
+  float clip_x;
+  float clip_y;
+  float clip_width;
+  float clip_height;
+} Lattice_Layout;
+
+//A rectangle of cells, empty when rows or cols is less than 1.
+typedef struct Lattice_Rect {
+  int row;
+  int col;
+  int rows;
+  int cols;
+} Lattice_Rect;
+
+#define LATTICE_MAX_COLORS 16
+//Boards whose cells are smaller than this many pixels across are drawn with
+//lattice_draw_grid.
+#define LATTICE_GRID_CELL_PIXELS 6.0f
+
+//Compile the shaders. Returns false, and the renderer stays unavailable, if
+//the context isn't OpenGL 3.3 or something fails. Call after glewInit.
+bool lattice_init(void);
+
+bool lattice_available(void);
+
+//Room for count instances, valid until the next call.
+Lattice_Instance * lattice_instances(const int count);
+
+//Draw count instances from lattice_instances. palette holds colors RGB
+//triples between 0 and 1.
+void lattice_draw(const Lattice_Layout * const layout, const int count, const float * const palette, const int colors);
+
+//Draw a whole board from its state grids, which are rows by cols and hold 0
+//where cells is 0. Cells whose states differ show the inner state, without a
+//stroke since it would be less than a pixel wide. first_triangle_facing is
+//the facing of the top left triangle, and only used for triangles.
+//changed holds every cell whose states changed since the board was last drawn
+//with this function. shape must change whenever the board gets a new shape,
+//like game_shape does. The whole board is uploaded instead when its size,
+//shape or cells array is not the one drawn last time.
+void lattice_draw_grid(const Lattice_Layout * const layout, const int rows, const int cols, const uint8_t * const outer, const uint8_t * const inner, const uint8_t * const cells, const int shape, const Lattice_Rect changed, const bool first_triangle_facing, const float * const palette, const int colors);
+
+void lattice_delete(void);
+
+#endif
@@ -0,0 +1,31 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+//nanovg's OpenGL 3 backend, used with an OpenGL 3.2 core context. Each draw
+//call's uniforms are kept in one uniform buffer, so a call only binds a range
+//of it instead of uploading its uniforms one by one.
+
+#include <GL/glew.h>
+#include "nanovg.h"
+#define NANOVG_GL3_IMPLEMENTATION
+#define NANOVG_GL_USE_UNIFORMBUFFER 1
+#include "nanovg_gl.h"
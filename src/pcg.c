@@ -0,0 +1,91 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+#include <stdbool.h>
+#include "pcg.h"
+
+//Games use their uid as their stream, so threads start well past them.
+#define PCG32_THREAD_STREAM_BASE (1ULL << 32)
+
+static uint64_t global_seed = PCG32_DEFAULT_SEED;
+static uint64_t next_thread_stream = PCG32_THREAD_STREAM_BASE;
+
+void pcg32_seed(Pcg32 * rng, const uint64_t seed, const uint64_t stream)
+{
+  rng->state = 0;
+  rng->increment = (stream << 1) | 1;
+  pcg32_random(rng);
+  rng->state += seed;
+  pcg32_random(rng);
+}
+
+void pcg32_fill(Pcg32 * rng, uint32_t * const words, const int n)
+{
+  //Work on a local copy so the compiler can keep the state in registers.
+  Pcg32 local = *rng;
+  for(int i = 0; i < n; i++) words[i] = pcg32_random(&local);
+  *rng = local;
+}
+
+void pcg32_advance(Pcg32 * rng, uint64_t delta)
+{
+  //Square and multiply on the affine step state * multiplier + increment.
+  uint64_t multiplier = PCG32_MULTIPLIER;
+  uint64_t increment = rng->increment;
+  uint64_t total_multiplier = 1;
+  uint64_t total_increment = 0;
+  while(delta > 0)
+  {
+    if(delta & 1)
+    {
+      total_multiplier *= multiplier;
+      total_increment = total_increment * multiplier + increment;
+    }
+    increment = (multiplier + 1) * increment;
+    multiplier *= multiplier;
+    delta >>= 1;
+  }
+  rng->state = total_multiplier * rng->state + total_increment;
+}
+
+void pcg32_set_global_seed(const uint64_t seed)
+{
+  global_seed = seed;
+}
+
+uint64_t pcg32_global_seed(void)
+{
+  return global_seed;
+}
+
+Pcg32 * pcg32_thread(void)
+{
+  static _Thread_local Pcg32 rng;
+  static _Thread_local bool seeded = false;
+  if(!seeded)
+  {
+    uint64_t stream = __atomic_fetch_add(&next_thread_stream, 1, __ATOMIC_RELAXED);
+    pcg32_seed(&rng, global_seed, stream);
+    seeded = true;
+  }
+  return &rng;
+}
@@ -0,0 +1,87 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+//PCG32 random number generator, see https://www.pcg-random.org.
+//
+//Each generator has a seed and a stream. Generators with the same seed but
+//different streams give independent sequences, so every game and every thread
+//gets its own stream and nothing shares state or a lock.
+
+#ifndef POCICO_PCG_H
+#define POCICO_PCG_H
+
+#include <stdint.h>
+
+typedef struct Pcg32 {
+  uint64_t state;
+  uint64_t increment; //Always odd once seeded, so 0 means not seeded yet.
+} Pcg32;
+
+#define PCG32_MULTIPLIER 6364136223846793005ULL
+#define PCG32_DEFAULT_SEED 0x853c49e6748fea9bULL
+
+void pcg32_seed(Pcg32 * rng, const uint64_t seed, const uint64_t stream);
+
+static inline uint32_t pcg32_random(Pcg32 * rng)
+{
+  uint64_t old_state = rng->state;
+  rng->state = old_state * PCG32_MULTIPLIER + rng->increment;
+  uint32_t xorshifted = (uint32_t)(((old_state >> 18) ^ old_state) >> 27);
+  uint32_t rotation = (uint32_t)(old_state >> 59);
+  return (xorshifted >> rotation) | (xorshifted << ((-rotation) & 31));
+}
+
+//Return a number in [0, bound) without bias, using Lemire's multiply and
+//reject method. Only one draw in 2^32 / bound needs a division.
+static inline uint32_t pcg32_bounded(Pcg32 * rng, const uint32_t bound)
+{
+  uint64_t product = (uint64_t)pcg32_random(rng) * bound;
+  uint32_t low = (uint32_t)product;
+  if(low < bound)
+  {
+    uint32_t threshold = -bound % bound;
+    while(low < threshold)
+    {
+      product = (uint64_t)pcg32_random(rng) * bound;
+      low = (uint32_t)product;
+    }
+  }
+  return (uint32_t)(product >> 32);
+}
+
+//Fill words with random numbers.
+void pcg32_fill(Pcg32 * rng, uint32_t * const words, const int n);
+
+//Jump ahead delta steps in O(log delta), e.g. to split one stream into blocks.
+void pcg32_advance(Pcg32 * rng, uint64_t delta);
+
+//The seed used for the per thread generators and games that haven't been
+//seeded. Defaults to PCG32_DEFAULT_SEED so runs are reproducible unless
+//someone picks a seed.
+void pcg32_set_global_seed(const uint64_t seed);
+uint64_t pcg32_global_seed(void);
+
+//This thread's generator. It is seeded with the global seed on first use and
+//gets a stream no other thread or game uses.
+Pcg32 * pcg32_thread(void);
+
+#endif
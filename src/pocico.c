@@ -0,0 +1,1548 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pocico.h"
+#include "bitboard.h"
+#include "simd.h"
+#include "trace.h"
+
+//The stored right state minus the stored left state at index, mod mod.
+static inline int stored_difference(const Game * const game, const int index)
+{
+  int difference = game->right_state[index] - game->left_state[index];
+  return difference < 0 ? difference + game->mod : difference;
+}
+
+//Work out game->mismatches from the offsets. A position matches when its
+//stored difference is the left offset minus the right one.
+static inline void offsets_mismatches(Game * const game)
+{
+  const Offsets * offsets = game->offsets;
+  int difference = offsets->left - offsets->right;
+  if(difference < 0) difference += game->mod;
+  game->mismatches = game_number_of_states(game) - offsets->differences[difference];
+}
+
+//Add times to every state of one of a game's sides by adding it to the side's
+//offset.
+static inline void shift_offset(Game * const game, uint8_t * const state, const int times)
+{
+  Offsets * offsets = game->offsets;
+  if(state == game->left_state) offsets->left = add_mod(offsets->left, times, game->mod);
+  else offsets->right = add_mod(offsets->right, times, game->mod);
+  offsets_mismatches(game);
+}
+
+//Add times to state[index], keeping game->mismatches up to date when state is
+//one of the game's own sides. Any other array, like the scratch copies the
+//solver clicks on, is just changed.
+static inline void shift_state(Game * const game, uint8_t * const state, const int index, const int times)
+{
+  if(state != game->left_state && state != game->right_state)
+  {
+    state[index] = add_mod(state[index], times, game->mod);
+    return;
+  }
+  if(game->offsets != NULL)
+  {
+    game->offsets->differences[stored_difference(game, index)]--;
+    state[index] = add_mod(state[index], times, game->mod);
+    game->offsets->differences[stored_difference(game, index)]++;
+    offsets_mismatches(game);
+    return;
+  }
+  const uint8_t * other = (state == game->left_state) ? game->right_state : game->left_state;
+  int before = state[index] != other[index];
+  state[index] = add_mod(state[index], times, game->mod);
+  game->mismatches += (state[index] != other[index]) - before;
+}
+
+//shift_state for count states starting at first, done with the SIMD kernels.
+static void shift_states(Game * const game, uint8_t * const state, const int first, const int count, const int times)
+{
+  if(state != game->left_state && state != game->right_state)
+  {
+    simd_add_mod(state + first, count, times, game->mod);
+    return;
+  }
+  const uint8_t * other = (state == game->left_state) ? game->right_state : game->left_state;
+  game->mismatches -= simd_mismatches(state + first, other + first, count);
+  simd_add_mod(state + first, count, times, game->mod);
+  game->mismatches += simd_mismatches(state + first, other + first, count);
+}
+
+//Shared by randomize and the polyform versions, defined with randomize.
+static void finish_randomize(Game * game, const uint8_t * const old_left_state, const uint8_t * const old_right_state);
+
+//Polyform generation. The generator's grid marks the filled cells and the
+//potential ones next to them, and the filled and potential lists hold the
+//same cells so a random one can be picked in O(1).
+
+//Fill in up to four cells next to (row, col) that are inside the workspace.
+//Squares touch the cells above, below, left and right of them. Triangles touch
+//the cells to their left and right, and the one below if they face up or the
+//one above if they face down.
+static int generator_adjacent(
+  const Polyform_Generator * const g,
+  const Polyomino_Point p,
+  Polyomino_Point * const adjacent
+)
+{
+  int count = 0;
+  bool up = !g->triangles;
+  bool down = !g->triangles;
+  if(g->triangles)
+  {
+    if(polyiamond_facing(p.row, p.col, g->first_triangle_facing) == POLYIAMOND_FACING_UP) down = true;
+    else up = true;
+  }
+  if(up && 0 < p.row) adjacent[count++] = (Polyomino_Point){p.row - 1, p.col};
+  if(down && p.row < g->rows - 1) adjacent[count++] = (Polyomino_Point){p.row + 1, p.col};
+  if(0 < p.col) adjacent[count++] = (Polyomino_Point){p.row, p.col - 1};
+  if(p.col < g->cols - 1) adjacent[count++] = (Polyomino_Point){p.row, p.col + 1};
+  return count;
+}
+
+static void generator_push(Polyform_Generator * g, Polyomino_Point * list, int * count, const Polyomino_Point p)
+{
+  g->slot[p.row * g->cols + p.col] = *count;
+  list[(*count)++] = p;
+}
+
+//Remove list[i] by moving the last cell into its place.
+static void generator_remove(Polyform_Generator * g, Polyomino_Point * list, int * count, const int i)
+{
+  (*count)--;
+  list[i] = list[*count];
+  g->slot[list[i].row * g->cols + list[i].col] = i;
+}
+
+//Make room in the lists for one more filled cell and the four potential cells
+//next to it. Returns false, leaving the lists as they were, if there is no
+//memory for that.
+static bool generator_reserve(Polyform_Generator * g)
+{
+  if(g->filled_count < g->capacity && g->potential_count + 4 <= g->capacity) return true;
+  int capacity = g->capacity * 2;
+  Polyomino_Point * filled = realloc(g->filled, sizeof(Polyomino_Point) * capacity);
+  if(filled == NULL) return false;
+  g->filled = filled;
+  Polyomino_Point * potential = realloc(g->potential, sizeof(Polyomino_Point) * capacity);
+  if(potential == NULL) return false;
+  g->potential = potential;
+  g->capacity = capacity;
+  return true;
+}
+
+//Double the workspace's height if grow_rows, else its width, keeping the shape
+//in the middle. The shape moves by an even number of rows and columns, so
+//triangles keep their facing. Return where p moved to.
+static Polyomino_Point generator_grow(Polyform_Generator * g, const bool grow_rows, Polyomino_Point p)
+{
+  int rows = grow_rows ? g->rows * 2 : g->rows;
+  int cols = grow_rows ? g->cols : g->cols * 2;
+  Polyomino_Point shift = {((rows - g->rows) / 2) & ~1, ((cols - g->cols) / 2) & ~1};
+  free(g->grid);
+  free(g->slot);
+  g->rows = rows;
+  g->cols = cols;
+  g->grid = calloc((size_t)rows * cols, sizeof(uint8_t)); //All POLYFORM_EMPTY.
+  g->slot = malloc(sizeof(int) * (size_t)rows * cols);
+  for(int i = 0; i < g->filled_count; i++)
+  {
+    g->filled[i].row += shift.row;
+    g->filled[i].col += shift.col;
+    int index = g->filled[i].row * cols + g->filled[i].col;
+    g->grid[index] = POLYFORM_FILLED;
+    g->slot[index] = i;
+  }
+  for(int i = 0; i < g->potential_count; i++)
+  {
+    g->potential[i].row += shift.row;
+    g->potential[i].col += shift.col;
+    int index = g->potential[i].row * cols + g->potential[i].col;
+    g->grid[index] = POLYFORM_POTENTIAL;
+    g->slot[index] = i;
+  }
+  g->origin.row += shift.row;
+  g->origin.col += shift.col;
+  p.row += shift.row;
+  p.col += shift.col;
+  return p;
+}
+
+//Fill the cell at p. Returns false, without changing the shape, if the lists
+//can't grow.
+static bool generator_fill(Polyform_Generator * g, Polyomino_Point p)
+{
+  if(!generator_reserve(g)) return false;
+  //A filled cell needs all of its neighbours inside the workspace.
+  if(p.row == 0 || p.row == g->rows - 1) p = generator_grow(g, true, p);
+  if(p.col == 0 || p.col == g->cols - 1) p = generator_grow(g, false, p);
+
+  int index = p.row * g->cols + p.col;
+  if(g->grid[index] == POLYFORM_POTENTIAL)
+  {
+    generator_remove(g, g->potential, &g->potential_count, g->slot[index]);
+  }
+  g->grid[index] = POLYFORM_FILLED;
+  generator_push(g, g->filled, &g->filled_count, p);
+
+  //We need to add new potential cells next to our new filled cell.
+  Polyomino_Point adjacent[4];
+  int count = generator_adjacent(g, p, adjacent);
+  for(int i = 0; i < count; i++)
+  {
+    int a = adjacent[i].row * g->cols + adjacent[i].col;
+    if(g->grid[a] == POLYFORM_EMPTY)
+    {
+      g->grid[a] = POLYFORM_POTENTIAL;
+      generator_push(g, g->potential, &g->potential_count, adjacent[i]);
+    }
+  }
+  return true;
+}
+
+//Empty the last filled cell. It stays next to the shape so it becomes
+//potential, while potential cells that were only next to it go back to empty.
+//Returns false, without changing the shape, if the lists can't grow.
+static bool generator_unfill(Polyform_Generator * g)
+{
+  if(!generator_reserve(g)) return false;
+  Polyomino_Point p = g->filled[--g->filled_count];
+  g->grid[p.row * g->cols + p.col] = POLYFORM_POTENTIAL;
+  generator_push(g, g->potential, &g->potential_count, p);
+
+  Polyomino_Point adjacent[4];
+  int count = generator_adjacent(g, p, adjacent);
+  for(int k = 0; k < count; k++)
+  {
+    int a = adjacent[k].row * g->cols + adjacent[k].col;
+    if(g->grid[a] != POLYFORM_POTENTIAL) continue;
+    Polyomino_Point around[4];
+    int around_count = generator_adjacent(g, adjacent[k], around);
+    bool touching = false;
+    for(int j = 0; j < around_count; j++)
+    {
+      if(g->grid[around[j].row * g->cols + around[j].col] == POLYFORM_FILLED) touching = true;
+    }
+    if(!touching)
+    {
+      generator_remove(g, g->potential, &g->potential_count, g->slot[a]);
+      g->grid[a] = POLYFORM_EMPTY;
+    }
+  }
+  return true;
+}
+
+//Start a new shape with one filled cell in the middle of the workspace. The
+//workspace is allocated the first time, and after that only the cells of the
+//old shape are cleared. The top left triangle faces up, and so does the
+//starting one since it is an even number of rows and columns away.
+#define GENERATOR_START_SIDE 64
+static void generator_reset(Polyform_Generator * g, const bool triangles)
+{
+  if(g->grid == NULL)
+  {
+    g->rows = GENERATOR_START_SIDE;
+    g->cols = GENERATOR_START_SIDE;
+    g->capacity = GENERATOR_START_SIDE;
+    g->grid = calloc(g->rows * g->cols, sizeof(uint8_t)); //All POLYFORM_EMPTY.
+    g->slot = malloc(sizeof(int) * g->rows * g->cols);
+    g->filled = malloc(sizeof(Polyomino_Point) * g->capacity);
+    g->potential = malloc(sizeof(Polyomino_Point) * g->capacity);
+  }
+  for(int i = 0; i < g->filled_count; i++)
+  {
+    g->grid[g->filled[i].row * g->cols + g->filled[i].col] = POLYFORM_EMPTY;
+  }
+  for(int i = 0; i < g->potential_count; i++)
+  {
+    g->grid[g->potential[i].row * g->cols + g->potential[i].col] = POLYFORM_EMPTY;
+  }
+  g->filled_count = 0;
+  g->potential_count = 0;
+  g->triangles = triangles;
+  g->first_triangle_facing = POLYIAMOND_FACING_UP;
+  generator_fill(g, (Polyomino_Point){(g->rows / 2) & ~1, (g->cols / 2) & ~1});
+}
+
+//Grow or shrink the shape until it has size cells. Growing fills a random
+//potential cell, so every cell was next to an earlier one when it was filled
+//and any start of the filled list is a connected shape. Shrinking empties the
+//last filled cell, which never splits the shape, and needs no search of it.
+//It stops short if the lists can't grow, so the size is filled_count after.
+static void generator_resize(Polyform_Generator * g, Pcg32 * rng, const int size)
+{
+  while(g->filled_count < size)
+  {
+    if(!generator_fill(g, g->potential[pcg32_bounded(rng, g->potential_count)])) break;
+  }
+  while(size < g->filled_count)
+  {
+    if(!generator_unfill(g)) break;
+  }
+}
+
+//Clip the shape to its bounding box and replace a polyform's grids and cells
+//mask with ones of that size. Every state starts at 0: a new shape is only
+//made when randomizing, which redraws all of the states straight after, like
+//the other growable games do when they change size.
+static void generator_clip(
+  Polyform_Generator * g,
+  uint8_t ** left_grid,
+  uint8_t ** right_grid,
+  uint8_t ** cells,
+  int * rows,
+  int * cols
+)
+{
+  Polyomino_Point minimum = g->filled[0];
+  Polyomino_Point maximum = g->filled[0];
+  for(int i = 1; i < g->filled_count; i++)
+  {
+    Polyomino_Point p = g->filled[i];
+    if(p.row < minimum.row) minimum.row = p.row;
+    if(p.col < minimum.col) minimum.col = p.col;
+    if(maximum.row < p.row) maximum.row = p.row;
+    if(maximum.col < p.col) maximum.col = p.col;
+  }
+  int clipped_rows = maximum.row - minimum.row + 1;
+  int clipped_cols = maximum.col - minimum.col + 1;
+
+  uint8_t * left = calloc(clipped_rows * clipped_cols, sizeof(uint8_t));
+  uint8_t * right = calloc(clipped_rows * clipped_cols, sizeof(uint8_t));
+  uint8_t * mask = calloc(clipped_rows * clipped_cols, sizeof(uint8_t));
+  for(int i = 0; i < g->filled_count; i++)
+  {
+    Polyomino_Point p = g->filled[i];
+    int index = (p.row - minimum.row) * clipped_cols + (p.col - minimum.col);
+    mask[index] = POLYFORM_CELL;
+  }
+  free(*left_grid);
+  free(*right_grid);
+  free(*cells);
+  *left_grid = left;
+  *right_grid = right;
+  *cells = mask;
+  *rows = clipped_rows;
+  *cols = clipped_cols;
+  g->origin = minimum;
+}
+
+//Build the neighbour lists of a clipped polyform from its cells mask.
+//Squares touch the cells above, below, left and right of them. Triangles touch
+//the cells to their left and right, and the one below if they face up or the
+//one above if they face down.
+static void build_neighbours(
+  Polyform_Neighbours * const n,
+  const uint8_t * const cells,
+  const int rows,
+  const int cols,
+  const bool triangles,
+  const bool first_triangle_facing
+)
+{
+  free(n->live);
+  free(n->dense);
+  free(n->first_neighbour);
+  free(n->neighbours);
+  n->count = 0;
+  n->dense = malloc(sizeof(int) * rows * cols);
+  for(int i = 0; i < rows * cols; i++)
+  {
+    n->dense[i] = cells[i] ? n->count++ : -1;
+  }
+  n->live = malloc(sizeof(int) * n->count);
+  n->first_neighbour = malloc(sizeof(int) * (n->count + 1));
+  //No cell touches more than four others.
+  n->neighbours = malloc(sizeof(int) * n->count * 5);
+
+  int k = 0;
+  for(int r = 0; r < rows; r++)
+  {
+    for(int c = 0; c < cols; c++)
+    {
+      int index = r * cols + c;
+      int cell = n->dense[index];
+      if(cell < 0) continue;
+      n->live[cell] = index;
+      n->first_neighbour[cell] = k;
+      n->neighbours[k++] = index;
+      bool up = !triangles;
+      bool down = !triangles;
+      if(triangles)
+      {
+        if(polyiamond_facing(r, c, first_triangle_facing) == POLYIAMOND_FACING_UP) down = true;
+        else up = true;
+      }
+      if(up && 0 < r && cells[index - cols]) n->neighbours[k++] = index - cols;
+      if(down && r < rows - 1 && cells[index + cols]) n->neighbours[k++] = index + cols;
+      if(0 < c && cells[index - 1]) n->neighbours[k++] = index - 1;
+      if(c < cols - 1 && cells[index + 1]) n->neighbours[k++] = index + 1;
+    }
+  }
+  n->first_neighbour[n->count] = k;
+}
+
+//Click a polyform cell, given by its dense index.
+static inline void transform_cell(
+  Game * const game,
+  const Polyform_Neighbours * const n,
+  const int cell,
+  uint8_t * const state,
+  const int times
+)
+{
+  for(int k = n->first_neighbour[cell]; k < n->first_neighbour[cell + 1]; k++)
+  {
+    shift_state(game, state, n->neighbours[k], times);
+  }
+}
+
+//Add the positions a click on cell changed to the dirty rectangle.
+static void dirty_cell(Polyform_Dirty * dirty, const Polyform_Neighbours * const n, const int cell, const int cols)
+{
+  for(int k = n->first_neighbour[cell]; k < n->first_neighbour[cell + 1]; k++)
+  {
+    int row = n->neighbours[k] / cols;
+    int col = n->neighbours[k] % cols;
+    if(row < dirty->minimum.row) dirty->minimum.row = row;
+    if(col < dirty->minimum.col) dirty->minimum.col = col;
+    if(dirty->maximum.row < row) dirty->maximum.row = row;
+    if(dirty->maximum.col < col) dirty->maximum.col = col;
+  }
+}
+
+static void dirty_all(Polyform_Dirty * dirty, const int rows, const int cols)
+{
+  dirty->minimum = (Polyomino_Point){0, 0};
+  dirty->maximum = (Polyomino_Point){rows - 1, cols - 1};
+}
+
+Polyform_Dirty polyform_take_dirty(Polyform_Dirty * dirty)
+{
+  Polyform_Dirty taken = *dirty;
+  dirty->minimum = (Polyomino_Point){INT_MAX, INT_MAX};
+  dirty->maximum = (Polyomino_Point){-1, -1};
+  return taken;
+}
+
+//Randomize a polyform whose shape is already set. The left side is drawn for
+//the whole grid with the cells mask keeping dead positions at 0, and the
+//right side is scrambled by clicking each cell a random number of times.
+static void randomize_polyform(Game * game, const Polyform_Neighbours * const n, const uint8_t * const cells, const int positions)
+{
+  //Big boards would overflow the stack, so the random numbers go on the heap.
+  uint32_t * random = malloc(sizeof(uint32_t) * (positions > n->count ? positions : n->count));
+  uint8_t * times = malloc(n->count);
+
+  //Randomize the left state, and
+  //set right state to be exactly left state.
+  pcg32_fill(&game->rng, random, positions);
+  simd_random_states(game->left_state, random, cells, positions, game->mod, &game->rng);
+  memcpy(game->right_state, game->left_state, positions);
+
+  //Randomize the right state by clicking every cell.
+  pcg32_fill(&game->rng, random, n->count);
+  simd_random_states(times, random, NULL, n->count, game->mod, &game->rng);
+  for(int cell = 0; cell < n->count; cell++)
+  {
+    transform_cell(game, n, cell, game->right_state, times[cell]);
+  }
+  free(random);
+  free(times);
+
+  //The left and right states have to be different.
+  finish_randomize(game, NULL, NULL);
+}
+
+Polyomino game_10_polyomino;
+//Set up a polyomino's grids after its generator's shape changed.
+static void clip_polyomino(Polyomino * polyomino)
+{
+  polyomino->generation++;
+  generator_clip(
+    &polyomino->generator,
+    &polyomino->left_grid,
+    &polyomino->right_grid,
+    &polyomino->cells,
+    &polyomino->rows,
+    &polyomino->cols
+  );
+  polyomino->clipped_rows = polyomino->rows;
+  polyomino->clipped_cols = polyomino->cols;
+  polyomino->minimum.row = 0;
+  polyomino->minimum.col = 0;
+  polyomino->maximum.row = polyomino->rows - 1;
+  polyomino->maximum.col = polyomino->cols - 1;
+  build_neighbours(&polyomino->neighbours, polyomino->cells, polyomino->rows, polyomino->cols, false, false);
+}
+void generate_polyomino(Polyomino * polyomino, Pcg32 * rng)
+{
+  if(polyomino->size < 1 || polyomino->size > POLYOMINO_MAX) polyomino->size = 1;
+
+  generator_reset(&polyomino->generator, false);
+  generator_resize(&polyomino->generator, rng, polyomino->size);
+  polyomino->size = polyomino->generator.filled_count;
+  clip_polyomino(polyomino);
+}
+void resize_polyomino(Polyomino * polyomino, Pcg32 * rng)
+{
+  if(polyomino->generator.filled_count == 0)
+  {
+    generate_polyomino(polyomino, rng);
+    return;
+  }
+  if(polyomino->size < 1 || polyomino->size > POLYOMINO_MAX) polyomino->size = 1;
+  generator_resize(&polyomino->generator, rng, polyomino->size);
+  polyomino->size = polyomino->generator.filled_count;
+  clip_polyomino(polyomino);
+}
+void polyomino_transform(
+  Game * const game,
+  const int row,
+  const int col,
+  uint8_t * const state,
+  const int times
+)
+{
+  //Warning: not much error checking in this function.
+  Polyomino * p = game->special;
+  if(row < p->minimum.row || p->maximum.row < row || col < p->minimum.col || p->maximum.col < col)
+  {
+    //This should not happen. Maybe use an assert instead.
+    return;
+  }
+
+  //Only positions that are part of the polyform can be transformed.
+  int cell = p->neighbours.dense[row * p->cols + col];
+  if(0 <= cell)
+  {
+    transform_cell(game, &p->neighbours, cell, state, times);
+    //Scratch copies, like the ones the solver clicks on, aren't drawn.
+    if(state == game->left_state || state == game->right_state)
+    {
+      dirty_cell(&p->dirty, &p->neighbours, cell, p->cols);
+    }
+  }
+}
+//Transform using a position in the grid instead of a (row, col) pair, so the
+//polyomino can be used through game->transform like every other game.
+//The position is row * cols + col.
+static void polyomino_position_transform(
+  Game * const game,
+  const int position,
+  uint8_t * const state,
+  const int times
+)
+{
+  Polyomino * p = game->special;
+  polyomino_transform(game, position / p->cols, position % p->cols, state, times);
+}
+void polyomino_init(Game * game)
+{
+  Polyomino * p = game->special;
+  p->transform = polyomino_transform;
+  p->size = game->growable_data.number_of_states;
+  generate_polyomino(p, &game->rng);
+  game->left_state = p->left_grid;
+  game->right_state = p->right_grid;
+  game->randomize(game);
+}
+bool matching_polyomino(const Game * const game, const uint8_t * const left_state, const uint8_t * const right_state)
+{
+  Polyomino * polyomino = game->special;
+  //Positions outside the polyomino hold 0 on both sides, so the whole grid
+  //can be compared at once.
+  return simd_matching(left_state, right_state, polyomino->rows * polyomino->cols);
+}
+void randomize_polyomino(Game * game)
+{
+  int number_of_states = game->number_of_states;
+  if(game->growable) number_of_states = game->growable_data.number_of_states;
+
+  //Since having an old state for polyomino will be a drag, let's just not worry
+  //about repeating an old state for this game.
+
+  //If you want to add that feature, then when building a polyomino you will
+  //need to make an integer array of size POLYOMINO_MAX, and each time a point
+  //is filled, store that state information into the integer array.
+
+  Polyomino * polyomino = game->special;
+
+  if(polyomino->size != number_of_states)
+  {
+    polyomino->size = number_of_states;
+    resize_polyomino(polyomino, &game->rng);
+    //There may not have been memory for all of it.
+    if(game->growable) game->growable_data.number_of_states = polyomino->size;
+    game->left_state = polyomino->left_grid;
+    game->right_state = polyomino->right_grid;
+  }
+
+  if(!bitboard_randomize(game, false))
+  {
+    randomize_polyform(game, &polyomino->neighbours, polyomino->cells, polyomino->rows * polyomino->cols);
+  }
+  dirty_all(&polyomino->dirty, polyomino->rows, polyomino->cols);
+}
+
+Polyiamond game_11_polyiamond;
+//Set up a polyiamond's grids after its generator's shape changed.
+static void clip_polyiamond(Polyiamond * polyiamond)
+{
+  polyiamond->generation++;
+  Polyform_Generator * g = &polyiamond->generator;
+  generator_clip(
+    g,
+    &polyiamond->left_grid,
+    &polyiamond->right_grid,
+    &polyiamond->cells,
+    &polyiamond->rows,
+    &polyiamond->cols
+  );
+  polyiamond->clipped_rows = polyiamond->rows;
+  polyiamond->clipped_cols = polyiamond->cols;
+  polyiamond->minimum.row = 0;
+  polyiamond->minimum.col = 0;
+  polyiamond->maximum.row = polyiamond->rows - 1;
+  polyiamond->maximum.col = polyiamond->cols - 1;
+  polyiamond->clipped_first_triangle_facing = polyiamond_facing(g->origin.row, g->origin.col, g->first_triangle_facing);
+  polyiamond->first_triangle_facing = polyiamond->clipped_first_triangle_facing;
+  build_neighbours(
+    &polyiamond->neighbours,
+    polyiamond->cells,
+    polyiamond->rows,
+    polyiamond->cols,
+    true,
+    polyiamond->first_triangle_facing
+  );
+}
+void generate_polyiamond(Polyiamond * polyiamond, Pcg32 * rng)
+{
+  if(polyiamond->size < 4 || polyiamond->size > POLYIAMOND_MAX) polyiamond->size = 4;
+
+  generator_reset(&polyiamond->generator, true);
+  generator_resize(&polyiamond->generator, rng, polyiamond->size);
+  polyiamond->size = polyiamond->generator.filled_count;
+  clip_polyiamond(polyiamond);
+}
+void resize_polyiamond(Polyiamond * polyiamond, Pcg32 * rng)
+{
+  if(polyiamond->generator.filled_count == 0)
+  {
+    generate_polyiamond(polyiamond, rng);
+    return;
+  }
+  if(polyiamond->size < 4 || polyiamond->size > POLYIAMOND_MAX) polyiamond->size = 4;
+  generator_resize(&polyiamond->generator, rng, polyiamond->size);
+  polyiamond->size = polyiamond->generator.filled_count;
+  clip_polyiamond(polyiamond);
+}
+void polyiamond_transform(
+  Game * const game,
+  const int row,
+  const int col,
+  uint8_t * const state,
+  const int times
+)
+{
+  //Warning: not much error checking in this function.
+  Polyiamond * p = game->special;
+  if(row < p->minimum.row || p->maximum.row < row || col < p->minimum.col || p->maximum.col < col)
+  {
+    //This should not happen. Maybe use an assert instead.
+    return;
+  }
+
+  //Only positions that are part of the polyform can be transformed.
+  int cell = p->neighbours.dense[row * p->cols + col];
+  if(0 <= cell)
+  {
+    transform_cell(game, &p->neighbours, cell, state, times);
+    //Scratch copies, like the ones the solver clicks on, aren't drawn.
+    if(state == game->left_state || state == game->right_state)
+    {
+      dirty_cell(&p->dirty, &p->neighbours, cell, p->cols);
+    }
+  }
+}
+//Transform using a position in the grid instead of a (row, col) pair, so the
+//polyiamond can be used through game->transform like every other game.
+//The position is row * cols + col.
+static void polyiamond_position_transform(
+  Game * const game,
+  const int position,
+  uint8_t * const state,
+  const int times
+)
+{
+  Polyiamond * p = game->special;
+  polyiamond_transform(game, position / p->cols, position % p->cols, state, times);
+}
+void polyiamond_init(Game * game)
+{
+  Polyiamond * p = game->special;
+  p->transform = polyiamond_transform;
+  p->size = game->growable_data.number_of_states;
+  generate_polyiamond(p, &game->rng);
+  game->left_state = p->left_grid;
+  game->right_state = p->right_grid;
+  game->randomize(game);
+}
+bool matching_polyiamond(const Game * const game, const uint8_t * const left_state, const uint8_t * const right_state)
+{
+  Polyiamond * polyiamond = game->special;
+  //Positions outside the polyiamond hold 0 on both sides, so the whole grid
+  //can be compared at once.
+  return simd_matching(left_state, right_state, polyiamond->rows * polyiamond->cols);
+}
+void randomize_polyiamond(Game * game)
+{
+  int number_of_states = game->number_of_states;
+  if(game->growable) number_of_states = game->growable_data.number_of_states;
+
+  //Since having an old state for polyiamond will be a drag, let's just not worry
+  //about repeating an old state for this game.
+
+  Polyiamond * polyiamond = game->special;
+
+  if(polyiamond->size != number_of_states)
+  {
+    polyiamond->size = number_of_states;
+    resize_polyiamond(polyiamond, &game->rng);
+    //There may not have been memory for all of it.
+    if(game->growable) game->growable_data.number_of_states = polyiamond->size;
+    game->left_state = polyiamond->left_grid;
+    game->right_state = polyiamond->right_grid;
+  }
+
+  if(!bitboard_randomize(game, false))
+  {
+    randomize_polyform(game, &polyiamond->neighbours, polyiamond->cells, polyiamond->rows * polyiamond->cols);
+  }
+  dirty_all(&polyiamond->dirty, polyiamond->rows, polyiamond->cols);
+}
+
+//Transform the state of one side of a game based on which position the player
+//clicked on.
+void
+transform(
+  Game * const game,
+  const int position,
+  uint8_t * const state,
+  const int times
+)
+{
+  int index = game->move_matrix_index[position];
+  int number_of_states_to_modify = game->move_matrix[index];
+  int first_state = index + 1;
+  for(int i = first_state; i < (first_state + number_of_states_to_modify); i++)
+  {
+    shift_state(game, state, game->move_matrix[i], times);
+  }
+}
+
+void triplets_transform(
+  Game * const game,
+  const int position,
+  uint8_t * const state,
+  const int times
+)
+{
+  //Warning: no error checking in this function.
+  int number_of_states = game->number_of_states;
+  if(game->growable) number_of_states = game->growable_data.number_of_states;
+  int left = position - 1;
+  if(left < 0)
+  {
+    left = number_of_states - 1;
+  }
+  int center = position;
+  int right = (position + 1) % number_of_states;
+  shift_state(game, state, left, times);
+  shift_state(game, state, center, times);
+  shift_state(game, state, right, times);
+}
+
+void sun_transform(
+  Game * const game,
+  const int position,
+  uint8_t * const state,
+  const int times
+)
+{
+  //Warning: no error checking in this function.
+  int number_of_states = game->number_of_states;
+  if(game->growable) number_of_states = game->growable_data.number_of_states;
+
+  if(position == 0)
+  {
+    if(game->offsets != NULL && (state == game->left_state || state == game->right_state))
+    {
+      shift_offset(game, state, times);
+    }
+    else
+    {
+      shift_states(game, state, 0, number_of_states, times);
+    }
+  }
+  else
+  {
+    int left = position - 1;
+    if(left == 0) left = number_of_states - 1;
+    int center = position;
+    int right = position + 1;
+    if(right == number_of_states) right = 1;
+
+    shift_state(game, state, left, times);
+    shift_state(game, state, center, times);
+    shift_state(game, state, right, times);
+    shift_state(game, state, 0, times);
+  }
+}
+
+void all_but_one_transform(
+  Game * const game,
+  const int position,
+  uint8_t * const state,
+  const int times
+)
+{
+  //Warning: no error checking in this function.
+  int number_of_states = game->number_of_states;
+  if(game->growable) number_of_states = game->growable_data.number_of_states;
+  if(game->offsets != NULL && (state == game->left_state || state == game->right_state))
+  {
+    //Add times to every state, then take it back off the one that is skipped.
+    shift_offset(game, state, times);
+    shift_state(game, state, position, game->mod - times % game->mod);
+    return;
+  }
+  shift_states(game, state, 0, position, times);
+  shift_states(game, state, position + 1, number_of_states - position - 1, times);
+}
+
+//Check whether two states match or not.
+bool matching(
+  const uint8_t * const left_state,
+  const uint8_t * const right_state,
+  int number_of_states
+)
+{
+  return simd_matching(left_state, right_state, number_of_states);
+}
+
+//Randomize the left and right states of a game.
+Randomize_Stats randomize_stats;
+
+//Return a random position holding state data.
+static int random_position(Game * game)
+{
+  int k = pcg32_bounded(&game->rng, game_number_of_states(game));
+  int number_of_positions = game_number_of_positions(game);
+  for(int i = 0; i < number_of_positions; i++)
+  {
+    if(game_position_has_state(game, i) && k-- == 0) return i;
+  }
+  return 0;
+}
+
+//Turn a fresh random draw into a valid puzzle without drawing again.
+//If the clicks cancelled out, one more click by 1 to mod - 1 always changes
+//something, since a click changes each of its states by exactly that much. If
+//both sides repeat the old state, shifting the same position on both sides
+//changes them without making them match. Pass NULL for old_left_state to skip
+//the second check.
+static void finish_randomize(Game * game, const uint8_t * const old_left_state, const uint8_t * const old_right_state)
+{
+  randomize_stats.randomizations++;
+  game->mismatches = count_mismatches(game);
+
+  if(matching_game(game))
+  {
+    int times = 1 + pcg32_bounded(&game->rng, game->mod - 1);
+    game->transform(game, random_position(game), game->right_state, times);
+    randomize_stats.extra_clicks++;
+  }
+
+  if(old_left_state != NULL)
+  {
+    settle_offsets(game);
+    int number_of_states = game_number_of_states(game);
+    if( matching(game->left_state, old_left_state, number_of_states) &&
+        matching(game->right_state, old_right_state, number_of_states) )
+    {
+      int position = random_position(game);
+      int times = 1 + pcg32_bounded(&game->rng, game->mod - 1);
+      game->left_state[position] = add_mod(game->left_state[position], times, game->mod);
+      game->right_state[position] = add_mod(game->right_state[position], times, game->mod);
+      randomize_stats.repeated_states++;
+    }
+  }
+}
+
+//Make room for a growable game's states. The buffers at least double each
+//time they grow, and new states start at 0. If there is no memory for that the
+//old buffers are kept, and the number of states is cut down to fit them.
+static void reserve_states(Game * game, const int count)
+{
+  Growable * growable = &game->growable_data;
+  if(count <= growable->capacity) return;
+  int capacity = growable->capacity > 0 ? growable->capacity : 32;
+  while(capacity < count) capacity *= 2;
+  uint8_t * left_state = realloc(game->left_state, capacity);
+  uint8_t * right_state = left_state == NULL ? NULL : realloc(game->right_state, capacity);
+  if(left_state != NULL) game->left_state = left_state;
+  if(right_state == NULL)
+  {
+    growable->number_of_states = growable->capacity;
+    return;
+  }
+  game->right_state = right_state;
+  memset(game->left_state + growable->capacity, 0, capacity - growable->capacity);
+  memset(game->right_state + growable->capacity, 0, capacity - growable->capacity);
+  growable->capacity = capacity;
+}
+
+void randomize(Game * game)
+{
+  int number_of_states = game->number_of_states;
+  if(game->growable)
+  {
+    reserve_states(game, game->growable_data.number_of_states);
+    number_of_states = game->growable_data.number_of_states;
+  }
+
+  //The old states are compared with the new ones, so they have to be the
+  //actual states.
+  settle_offsets(game);
+
+  //mod 2 games are much faster to randomize as bitboards.
+  if(bitboard_randomize(game, true))
+  {
+    settle_offsets(game);
+    return;
+  }
+
+  //Big boards would overflow the stack, so the copies go on the heap.
+  uint8_t * old_left_state = malloc(number_of_states);
+  uint8_t * old_right_state = malloc(number_of_states);
+  memcpy(old_left_state, game->left_state, number_of_states);
+  memcpy(old_right_state, game->right_state, number_of_states);
+
+  bool won = matching(game->left_state, game->right_state, number_of_states);
+
+  uint32_t * random = malloc(sizeof(uint32_t) * number_of_states);
+  uint8_t * times = malloc(number_of_states);
+
+  //Randomize the left state, and
+  //set right state to be exactly left state.
+  pcg32_fill(&game->rng, random, number_of_states);
+  simd_random_states(game->left_state, random, NULL, number_of_states, game->mod, &game->rng);
+  memcpy(game->right_state, game->left_state, number_of_states);
+  settle_offsets(game); //Count the differences of the new states.
+
+  //Randomize the right state by applying the transform function on it.
+  pcg32_fill(&game->rng, random, number_of_states);
+  simd_random_states(times, random, NULL, number_of_states, game->mod, &game->rng);
+  for(int i = 0; i < number_of_states; i++)
+  {
+    game->transform(game, i, game->right_state, times[i]);
+  }
+  free(random);
+  free(times);
+
+  //The left and right states have to be different. If the player hasn't won
+  //we are more picky, and either the left state has to be different than what
+  //it was before randomizing, or the right has to be different than what it
+  //was before randomizing. This ensures that when we randomize, there is a
+  //visible change. Otherwise there is a possibility that exactly the same
+  //state as before randomizing occurs again.
+  if(won)
+  {
+    finish_randomize(game, NULL, NULL);
+  }
+  else
+  {
+    finish_randomize(game, old_left_state, old_right_state);
+  }
+  free(old_left_state);
+  free(old_right_state);
+}
+
+void standard_init(Game * game)
+{
+  game->randomize(game);
+}
+
+uint8_t game_01_triforce_left_state[4];
+uint8_t game_01_triforce_right_state[4];
+const int game_01_triforce_move_matrix_index[] = {0, 4, 7, 10};
+const int game_01_triforce_move_matrix[] = {
+  3, 1, 2, 3, //Center
+  2, 0, 1,    //Top
+  2, 0, 2,    //Left
+  2, 0, 3,    //Right
+};
+
+uint8_t game_02_foursquare_left_state[4];
+uint8_t game_02_foursquare_right_state[4];
+const int game_02_foursquare_move_matrix_index[] = {0, 4, 8, 12};
+const int game_02_foursquare_move_matrix[] = {
+  3, 0, 1, 3, //Top left
+  3, 0, 1, 2, //Top right
+  3, 1, 2, 3, //Bottom right
+  3, 0, 2, 3, //Bottom left
+};
+
+uint8_t game_03_squarediamond_left_state[24];
+uint8_t game_03_squarediamond_right_state[24];
+const int game_03_squarediamond_move_matrix_index[] = {
+  0, 4, 8, 13, 18, 22,
+  26, 30, 35, 41, 47, 52,
+  56, 60, 65, 71, 77, 82,
+  86, 90, 94, 99, 104, 108
+};
+const int game_03_squarediamond_move_matrix[] = {
+  3, 0, 1, 11,          //0
+  3, 1, 0, 2,           //1
+  4, 2, 1, 3, 9,        //2
+  4, 3, 2, 4, 8,        //3
+  3, 4, 3, 5,           //4
+  3, 5, 4, 6,           //5
+  3, 6, 5, 7,           //6
+  4, 7, 6, 8, 16,       //7
+  5, 8, 3, 7, 9, 15,    //8
+  5, 9, 2, 8, 10, 14,   //9
+  4, 10, 9, 11, 13,     //10
+  3, 11, 0, 10,         //11
+  3, 12, 13, 23,        //12
+  4, 13, 10, 12, 14,    //13
+  5, 14, 9, 13, 15, 21, //14
+  5, 15, 8, 14, 16, 20, //15
+  4, 16, 7, 15, 17,     //16
+  3, 17, 16, 18,        //17
+  3, 18, 17, 19,        //18
+  3, 19, 18, 20,        //19
+  4, 20, 15, 19, 21,    //20
+  4, 21, 14, 20, 22,    //21
+  3, 22, 21, 23,        //22
+  3, 23, 12, 22,        //23
+};
+
+//https://en.wikipedia.org/wiki/Ammann–Beenker_tiling
+uint8_t game_04_ammann_beenker_left_state[24];
+uint8_t game_04_ammann_beenker_right_state[24];
+
+const int game_04_ammann_beenker_move_matrix_index[] = {
+  0, 6, 12, 16, 20, 26, 32, 36, 42, 46, 52, 56, 62, 66, 72, 76, 80, 86, 92, 98, 104, 110, 116, 122
+};
+const int game_04_ammann_beenker_move_matrix[] = {
+  5, 0, 2, 15, 16, 17,   //0
+  5, 1, 2, 3, 17, 18,    //1
+  3, 0, 1, 2,            //2
+  3, 1, 3, 4,            //3
+  5, 3, 4, 6, 18, 19,    //4
+  5, 5, 6, 8, 19, 20,    //5
+  3, 4, 5, 6,            //6
+  5, 7, 8, 10, 20, 21,   //7
+  3, 5, 7, 8,            //8
+  5, 9, 10, 12, 21, 22,  //9
+  3, 7, 9, 10,           //10
+  5, 11, 12, 14, 22, 23, //11
+  3, 9, 11, 12,          //12
+  5, 13, 14, 15, 16, 23, //13
+  3, 11, 13, 14,         //14
+  3, 0, 13, 15,          //15
+  5, 0, 13, 16, 17, 23,  //16
+  5, 0, 1, 16, 17, 18,   //17
+  5, 1, 4, 17, 18, 19,   //18
+  5, 4, 5, 18, 19, 20,   //19
+  5, 5, 7, 19, 20, 21,   //20
+  5, 7, 9, 20, 21, 22,   //21
+  5, 9, 11, 21, 22, 23,  //22
+  5, 11, 13, 16, 22, 23  //23
+};
+
+uint8_t game_05_trianglehexagon_left_state[6];
+uint8_t game_05_trianglehexagon_right_state[6];
+const int game_05_trianglehexagon_move_matrix_index[] = {0, 4, 8, 12, 16, 20};
+//Start with 0 at the top and go clockwise to get 1, 2, 3, 4, 5.
+const int game_05_trianglehexagon_move_matrix[] = {
+  3, 0, 1, 5, //0: Top
+  3, 0, 1, 2, //1
+  3, 1, 2, 3, //2
+  3, 2, 3, 4, //3
+  3, 3, 4, 5, //4
+  3, 4, 5, 0, //5
+};
+
+uint8_t game_06_diamondhexagon_left_state[12];
+uint8_t game_06_diamondhexagon_right_state[12];
+const int game_06_diamondhexagon_move_matrix_index[] = {0, 4, 10, 14, 20, 24, 30, 34, 40, 44, 50, 54};
+const int game_06_diamondhexagon_move_matrix[] = {
+  3, 0, 1, 11,        //0
+  5, 0, 1, 2, 3, 11,  //1
+  3, 1, 2, 3,         //2
+  5, 1, 2, 3, 4, 5,   //3
+  3, 3, 4, 5,         //4
+  5, 3, 4, 5, 6, 7,   //5
+  3, 5, 6, 7,         //6
+  5, 5, 6, 7, 8, 9,   //7
+  3, 7, 8, 9,         //8
+  5, 7, 8, 9, 10, 11, //9
+  3, 9, 10, 11,       //10
+  5, 0, 1, 9, 10, 11, //11
+};
+Offsets game_08_all_but_one_offsets;
+Offsets game_09_sun_offsets;
+
+Game game_triforce = {
+  .uid = 1,
+  .number_of_states = 4,
+  .left_state = game_01_triforce_left_state,
+  .right_state = game_01_triforce_right_state,
+  .mod = 2,
+  .move_matrix_index = game_01_triforce_move_matrix_index,
+  .move_matrix = game_01_triforce_move_matrix,
+  .init = standard_init,
+  .randomize = randomize,
+  .transform = transform,
+  .growable = false,
+  .growable_data = {0},
+  .special = NULL,
+  .rng = {0}, //Seeded by init_games.
+  .mismatches = 0, //Counted by randomize.
+  .offsets = NULL,
+};
+
+Game game_foursquare = {
+  .uid = 2,
+  .number_of_states = 4,
+  .left_state = game_02_foursquare_left_state,
+  .right_state = game_02_foursquare_right_state,
+  .mod = 2,
+  .move_matrix_index = game_02_foursquare_move_matrix_index,
+  .move_matrix = game_02_foursquare_move_matrix,
+  .init = standard_init,
+  .randomize = randomize,
+  .transform = transform,
+  .growable = false,
+  .growable_data = {0},
+  .special = NULL,
+  .rng = {0}, //Seeded by init_games.
+  .mismatches = 0, //Counted by randomize.
+  .offsets = NULL,
+};
+
+Game game_squarediamond = {
+  .uid = 3,
+  .number_of_states = 24,
+  .left_state = game_03_squarediamond_left_state,
+  .right_state = game_03_squarediamond_right_state,
+  .mod = 2,
+  .move_matrix_index = game_03_squarediamond_move_matrix_index,
+  .move_matrix = game_03_squarediamond_move_matrix,
+  .init = standard_init,
+  .randomize = randomize,
+  .transform = transform,
+  .growable = false,
+  .growable_data = {0},
+  .special = NULL,
+  .rng = {0}, //Seeded by init_games.
+  .mismatches = 0, //Counted by randomize.
+  .offsets = NULL,
+};
+
+Game game_ammann_beenker = {
+  .uid = 4,
+  .number_of_states = 24,
+  .left_state = game_04_ammann_beenker_left_state,
+  .right_state = game_04_ammann_beenker_right_state,
+  .mod = 2,
+  .move_matrix_index = game_04_ammann_beenker_move_matrix_index,
+  .move_matrix = game_04_ammann_beenker_move_matrix,
+  .init = standard_init,
+  .randomize = randomize,
+  .transform = transform,
+  .growable = false,
+  .growable_data = {0},
+  .special = NULL,
+  .rng = {0}, //Seeded by init_games.
+  .mismatches = 0, //Counted by randomize.
+  .offsets = NULL,
+};
+
+Game game_trianglehexagon = {
+  .uid = 5,
+  .number_of_states = 6,
+  .left_state = game_05_trianglehexagon_left_state,
+  .right_state = game_05_trianglehexagon_right_state,
+  .mod = 2,
+  .move_matrix_index = game_05_trianglehexagon_move_matrix_index,
+  .move_matrix = game_05_trianglehexagon_move_matrix,
+  .init = standard_init,
+  .randomize = randomize,
+  .transform = transform,
+  .growable = false,
+  .growable_data = {0},
+  .special = NULL,
+  .rng = {0}, //Seeded by init_games.
+  .mismatches = 0, //Counted by randomize.
+  .offsets = NULL,
+};
+
+Game game_diamondhexagon = {
+  .uid = 6,
+  .number_of_states = 12,
+  .left_state = game_06_diamondhexagon_left_state,
+  .right_state = game_06_diamondhexagon_right_state,
+  .mod = 2,
+  .move_matrix_index = game_06_diamondhexagon_move_matrix_index,
+  .move_matrix = game_06_diamondhexagon_move_matrix,
+  .init = standard_init,
+  .randomize = randomize,
+  .transform = transform,
+  .growable = false,
+  .growable_data = {0},
+  .special = NULL,
+  .rng = {0}, //Seeded by init_games.
+  .mismatches = 0, //Counted by randomize.
+  .offsets = NULL,
+};
+
+Game game_growabletriplets = {
+  .uid = 7,
+  .number_of_states = 5,
+  .left_state = NULL, //Allocated by randomize as the game grows.
+  .right_state = NULL,
+  .mod = 2,
+  .move_matrix_index = NULL,
+  .move_matrix = NULL,
+  .init = standard_init,
+  .randomize = randomize,
+  .transform = triplets_transform,
+  .growable = true,
+  .growable_data = {
+    .min_number_of_states = 4,
+    .number_of_states = 5,
+    .max_number_of_states = GROWABLE_TRIPLETS_MAX,
+    .capacity = 0, //The states grow on demand.
+  },
+  .special = NULL,
+  .rng = {0}, //Seeded by init_games.
+  .mismatches = 0, //Counted by randomize.
+  .offsets = NULL,
+};
+
+Game game_all_but_one = {
+  .uid = 8,
+  .number_of_states = 6,
+  .left_state = NULL, //Allocated by randomize as the game grows.
+  .right_state = NULL,
+  .mod = 2,
+  .move_matrix_index = NULL,
+  .move_matrix = NULL,
+  .init = standard_init,
+  .randomize = randomize,
+  .transform = all_but_one_transform,
+  .growable = true,
+  .growable_data = {
+    .min_number_of_states = 2,
+    .number_of_states = 6,
+    .max_number_of_states = ALL_BUT_ONE_MAX,
+    .capacity = 0, //The states grow on demand.
+  },
+  .special = NULL,
+  .rng = {0}, //Seeded by init_games.
+  .mismatches = 0, //Counted by randomize.
+  .offsets = &game_08_all_but_one_offsets,
+};
+
+Game game_sun = {
+  .uid = 9,
+  .number_of_states = 11,
+  .left_state = NULL, //Allocated by randomize as the game grows.
+  .right_state = NULL,
+  .mod = 2,
+  .move_matrix_index = NULL,
+  .move_matrix = NULL,
+  .init = standard_init,
+  .randomize = randomize,
+  .transform = sun_transform,
+  .growable = true,
+  .growable_data = {
+    .min_number_of_states = 5,
+    .number_of_states = 11,
+    .max_number_of_states = SUN_MAX,
+    .capacity = 0, //The states grow on demand.
+  },
+  .special = NULL,
+  .rng = {0}, //Seeded by init_games.
+  .mismatches = 0, //Counted by randomize.
+  .offsets = &game_09_sun_offsets,
+};
+
+Game game_polyomino = {
+  .uid = GAME_10_POLYOMINO_UID,
+  .number_of_states = 12,
+  .left_state = NULL, //The grid is allocated by polyomino_init.
+  .right_state = NULL,
+  .mod = 2,
+  .move_matrix_index = NULL,
+  .move_matrix = NULL,
+  .init = polyomino_init,
+  .randomize = randomize_polyomino,
+  .transform = polyomino_position_transform, //position is row * cols + col.
+  .growable = true,
+  .growable_data = {
+    .min_number_of_states = 4,
+    .number_of_states = 12,
+    .max_number_of_states = POLYOMINO_MAX,
+    .capacity = 0, //The states grow on demand.
+  },
+  .special = &game_10_polyomino,
+  .rng = {0}, //Seeded by init_games.
+  .mismatches = 0, //Counted by randomize.
+  .offsets = NULL,
+};
+
+Game game_polyiamond = {
+  .uid = GAME_11_POLYIAMOND_UID,
+  .number_of_states = 12,
+  .left_state = NULL, //The grid is allocated by polyiamond_init.
+  .right_state = NULL,
+  .mod = 2,
+  .move_matrix_index = NULL,
+  .move_matrix = NULL,
+  .init = polyiamond_init,
+  .randomize = randomize_polyiamond,
+  .transform = polyiamond_position_transform, //position is row * cols + col.
+  .growable = true,
+  .growable_data = {
+    .min_number_of_states = 4,
+    .number_of_states = 12,
+    .max_number_of_states = POLYIAMOND_MAX,
+    .capacity = 0, //The states grow on demand.
+  },
+  .special = &game_11_polyiamond,
+  .rng = {0}, //Seeded by init_games.
+  .mismatches = 0, //Counted by randomize.
+  .offsets = NULL,
+};
+
+//*
+Game * games[GAME_COUNT] = {
+  &game_triforce,
+  &game_foursquare,
+  &game_trianglehexagon,
+  &game_growabletriplets,
+  &game_all_but_one,
+  &game_sun,
+  &game_diamondhexagon,
+  &game_squarediamond,
+  &game_ammann_beenker,
+  &game_polyomino,
+  &game_polyiamond,
+};
+
+void seed_games(const uint64_t seed)
+{
+  pcg32_set_global_seed(seed);
+  for(int i = 0; i < GAME_COUNT; i++)
+  {
+    pcg32_seed(&games[i]->rng, seed, games[i]->uid);
+  }
+}
+
+void init_games(void)
+{
+  for(int i = 0; i < GAME_COUNT; i++)
+  {
+    //Games nobody seeded use the global seed, so runs are reproducible.
+    if(games[i]->rng.increment == 0)
+    {
+      pcg32_seed(&games[i]->rng, pcg32_global_seed(), games[i]->uid);
+    }
+    trace_begin_arg("init", games[i]->uid);
+    games[i]->init(games[i]);
+    trace_end();
+  }
+}
+
+int game_number_of_states(const Game * const game)
+{
+  if(game->growable) return game->growable_data.number_of_states;
+  return game->number_of_states;
+}
+
+int game_number_of_positions(const Game * const game)
+{
+  switch(game->uid)
+  {
+    case GAME_10_POLYOMINO_UID:
+    {
+      Polyomino * polyomino = game->special;
+      return polyomino->rows * polyomino->cols;
+    }
+    case GAME_11_POLYIAMOND_UID:
+    {
+      Polyiamond * polyiamond = game->special;
+      return polyiamond->rows * polyiamond->cols;
+    }
+    default:
+      return game_number_of_states(game);
+  }
+}
+
+bool game_position_has_state(const Game * const game, const int position)
+{
+  switch(game->uid)
+  {
+    case GAME_10_POLYOMINO_UID:
+    {
+      Polyomino * polyomino = game->special;
+      return polyomino->cells[position];
+    }
+    case GAME_11_POLYIAMOND_UID:
+    {
+      Polyiamond * polyiamond = game->special;
+      return polyiamond->cells[position];
+    }
+    default:
+      return true;
+  }
+}
+
+int game_shape(const Game * const game)
+{
+  switch(game->uid)
+  {
+    case GAME_10_POLYOMINO_UID:
+    {
+      Polyomino * polyomino = game->special;
+      return polyomino->generation;
+    }
+    case GAME_11_POLYIAMOND_UID:
+    {
+      Polyiamond * polyiamond = game->special;
+      return polyiamond->generation;
+    }
+    default:
+      return game_number_of_states(game);
+  }
+}
+
+int count_mismatches(const Game * const game)
+{
+  if(game->offsets != NULL)
+  {
+    int count = 0;
+    const int number_of_states = game_number_of_states(game);
+    for(int i = 0; i < number_of_states; i++)
+    {
+      count += game_state(game, game->left_state, i) != game_state(game, game->right_state, i);
+    }
+    return count;
+  }
+  //Positions outside a polyform hold 0 on both sides, so they never count.
+  return simd_mismatches(game->left_state, game->right_state, game_number_of_positions(game));
+}
+
+void settle_offsets(Game * game)
+{
+  Offsets * offsets = game->offsets;
+  if(offsets == NULL) return;
+  const int number_of_states = game_number_of_states(game);
+  simd_add_mod(game->left_state, number_of_states, offsets->left % game->mod, game->mod);
+  simd_add_mod(game->right_state, number_of_states, offsets->right % game->mod, game->mod);
+  offsets->left = 0;
+  offsets->right = 0;
+  memset(offsets->differences, 0, sizeof(offsets->differences));
+  for(int i = 0; i < number_of_states; i++)
+  {
+    offsets->differences[stored_difference(game, i)]++;
+  }
+  offsets_mismatches(game);
+}
+
+bool matching_game(const Game * const game)
+{
+  //Every change to a game's states keeps game->mismatches up to date. The
+  //full scan is O(n), so it is only a consistency check for the tests.
+#ifdef POCICO_CHECK_MISMATCHES
+  assert(game->mismatches == count_mismatches(game));
+#endif
+  return game->mismatches == 0;
+}
+
+bool increase_mod(Game * game)
+{
+  if(game->mod >= MAX_MOD) return false;
+  settle_offsets(game); //With the old mod.
+  game->mod++;
+  game->randomize(game);
+  return true;
+}
+
+bool decrease_mod(Game * game)
+{
+  if(game->mod <= MIN_MOD) return false;
+  settle_offsets(game); //With the old mod.
+  game->mod--;
+  game->randomize(game);
+  return true;
+}
+
+bool increase_size(Game * game)
+{
+  if(!game->growable) return false;
+  if(game->growable_data.number_of_states >= game->growable_data.max_number_of_states) return false;
+  ++game->growable_data.number_of_states;
+  game->randomize(game);
+  return true;
+}
+
+bool decrease_size(Game * game)
+{
+  if(!game->growable) return false;
+  if(game->growable_data.number_of_states <= game->growable_data.min_number_of_states) return false;
+  --game->growable_data.number_of_states;
+  game->randomize(game);
+  return true;
+}
+
+bool resize_game(Game * game, int number_of_states)
+{
+  if(!game->growable) return false;
+  if(number_of_states < game->growable_data.min_number_of_states) number_of_states = game->growable_data.min_number_of_states;
+  if(number_of_states > game->growable_data.max_number_of_states) number_of_states = game->growable_data.max_number_of_states;
+  if(number_of_states == game->growable_data.number_of_states) return false;
+  game->growable_data.number_of_states = number_of_states;
+  game->randomize(game);
+  return true;
+}
@@ -0,0 +1,371 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+//The headless puzzle engine. Nothing in here knows about SDL, OpenGL, nanovg
+//or audio. It is built together with bitboard.c, simd.c, pcg.c, solver.c and
+//trace.c into libpocico (make libpocico), which batch jobs and benchmarks like
+//bench/bench.c link against as well as the game.
+
+#ifndef POCICO_H
+#define POCICO_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "pcg.h"
+
+//The range of values mod can take. The game has one color per state, so
+//MAX_MOD is also the number of colors.
+#define MIN_MOD 2
+#define MAX_MOD 9
+
+typedef struct Growable {
+  const int min_number_of_states;
+  int number_of_states;
+  const int max_number_of_states;
+  int capacity; //The room in left_state and right_state, which grow on demand.
+} Growable;
+
+//All But One and the Sun's hub change nearly every state with one click, so
+//those games keep each side relative to an offset that is added to all of its
+//states. Such a click then only changes the offset and the one state it
+//skips, which is O(1). How many states differ only depends on how far apart
+//the two sides' stored states are, so differences counts the positions by
+//that and game->mismatches stays O(1) to keep up to date too.
+typedef struct Offsets {
+  uint8_t left; //Added to every stored left state, mod the game's mod.
+  uint8_t right;
+  int differences[MAX_MOD]; //By the stored right minus left state, mod mod.
+} Offsets;
+
+typedef struct Game {
+  const int uid;
+  const int number_of_states;
+  uint8_t * left_state;
+  uint8_t * right_state;
+  int mod;
+  const int * move_matrix_index;
+  const int * move_matrix;
+  void (*init) (struct Game*);
+  void (*randomize) (struct Game*);
+  void (*transform) (struct Game * const game, const int position, uint8_t * const state, const int times);
+  const bool growable;
+  Growable growable_data;
+  void * special;
+  Pcg32 rng; //Each game has its own stream, see seed_games.
+  int mismatches; //How many states differ between the left and right sides.
+  Offsets * offsets; //NULL unless the game keeps offsets, see Offsets.
+} Game;
+
+//The state at a position of one of a game's sides, i.e. state[position] plus
+//the side's offset if the game keeps offsets. state has to be
+//game->left_state or game->right_state.
+static inline int game_state(const Game * const game, const uint8_t * const state, const int position)
+{
+  if(game->offsets == NULL) return state[position];
+  int value = state[position] + (state == game->left_state ? game->offsets->left : game->offsets->right);
+  return value >= game->mod ? value - game->mod : value;
+}
+
+//Add a game's offsets into its stored states, so the arrays hold the actual
+//states again and can be read or written directly. This is O(n), and does
+//nothing for games without offsets.
+void settle_offsets(Game * game);
+
+//Polyomino functions and data.
+typedef struct Polyomino_Point {
+  int row;
+  int col;
+} Polyomino_Point, Polyiamond_Point;
+//The cells of a polyform while it is being generated.
+enum {POLYFORM_EMPTY, POLYFORM_POTENTIAL, POLYFORM_FILLED};
+//A polyform's cells mask holds POLYFORM_CELL where the grid is part of the
+//polyform and 0 elsewhere. It is all ones so it can mask whole rows of states.
+#define POLYFORM_CELL 0xff
+#define POLYOMINO_MAX 1000000 //The maximum size of the polyomino.
+//The cells of a polyform and who they affect, in compressed sparse row form.
+//Built once per shape so transforms and randomize only ever touch live cells.
+//Cell i sits at grid position live[i], and clicking it changes the positions
+//neighbours[first_neighbour[i]] up to neighbours[first_neighbour[i + 1]] - 1,
+//itself first.
+typedef struct Polyform_Neighbours {
+  int count; //The number of cells.
+  int * live;
+  int * dense; //dense[position] is the cell at a grid position, or -1.
+  int * first_neighbour; //count + 1 entries.
+  int * neighbours;
+} Polyform_Neighbours;
+//The workspace a polyform is grown in. It is kept between shapes, so growing
+//or shrinking a polyform by one cell only touches the cells around it instead
+//of rebuilding the whole shape. A cell is in the filled list or the potential
+//list (the empty cells next to the shape), and slot says where. The filled
+//list is kept in the order the cells were filled, so shrinking undoes the
+//latest growth. The workspace starts small and doubles in height or width
+//whenever the shape reaches its edge, so it stays in proportion to the shape's
+//bounding box.
+typedef struct Polyform_Generator {
+  int rows;
+  int cols;
+  bool triangles; //Polyiamond cells touch three others, polyomino cells four.
+  bool first_triangle_facing; //The facing of the workspace's top left triangle.
+  uint8_t * grid; //POLYFORM_EMPTY, POLYFORM_POTENTIAL or POLYFORM_FILLED.
+  int * slot;
+  Polyomino_Point * filled;
+  int filled_count;
+  Polyomino_Point * potential;
+  int potential_count;
+  int capacity; //The room in filled and potential.
+  Polyomino_Point origin; //Where the clipped grids start in the workspace.
+} Polyform_Generator;
+//The rectangle of a polyform's grids whose states changed since the renderer
+//last took it with polyform_take_dirty. Clicks add the cells they changed and
+//randomizing adds the whole grid. It is empty while maximum is above or left
+//of minimum.
+typedef struct Polyform_Dirty {
+  Polyomino_Point minimum;
+  Polyomino_Point maximum;
+} Polyform_Dirty;
+//Return the rectangle that changed and start again with an empty one.
+Polyform_Dirty polyform_take_dirty(Polyform_Dirty * dirty);
+//Once generated, a polyform's grids are clipped to its bounding box and
+//reallocated, so rows == clipped_rows, cols == clipped_cols and minimum is
+//(0, 0). Positions outside the polyform hold 0 on both sides, and cells says
+//which positions are part of it.
+typedef struct Polyomino {
+  uint8_t * left_grid;
+  uint8_t * right_grid;
+  uint8_t * cells; //POLYFORM_CELL where the grid holds a square, 0 elsewhere.
+  Polyform_Neighbours neighbours;
+  Polyform_Generator generator;
+  int size;
+  int rows;
+  int cols;
+  int clipped_rows;
+  int clipped_cols;
+  Polyomino_Point minimum;
+  Polyomino_Point maximum;
+  int generation; //Incremented every time a new shape is generated.
+  Polyform_Dirty dirty;
+  void (*transform) (struct Game * const game, const int row, const int col, uint8_t * const state, const int times);
+} Polyomino;
+extern Polyomino game_10_polyomino;
+//Generate a new polyomino of polyomino->size squares.
+void generate_polyomino(Polyomino * polyomino, Pcg32 * rng);
+//Grow or shrink the current polyomino until it has polyomino->size squares,
+//keeping its shape. The states start at 0, ready to be randomized.
+void resize_polyomino(Polyomino * polyomino, Pcg32 * rng);
+void polyomino_transform(Game * const game, const int row, const int col, uint8_t * const state, const int times);
+void polyomino_init(Game * game);
+bool matching_polyomino(const Game * const game, const uint8_t * const left_state, const uint8_t * const right_state);
+void randomize_polyomino(Game * game);
+
+//Polyiamond functions and data. Note we reuse some things from polyomino.
+#define POLYIAMOND_MAX 1000000 //The maximum size of the polyiamond.
+typedef struct Polyiamond {
+  uint8_t * left_grid;
+  uint8_t * right_grid;
+  uint8_t * cells; //POLYFORM_CELL where the grid holds a triangle, 0 elsewhere.
+  Polyform_Neighbours neighbours;
+  Polyform_Generator generator;
+  int size;
+  int rows;
+  int cols;
+  int clipped_rows;
+  int clipped_cols;
+  Polyiamond_Point minimum;
+  Polyiamond_Point maximum;
+  bool first_triangle_facing; //Either POLYIAMOND_FACING_UP or POLYIAMOND_FACING_DOWN.
+  bool clipped_first_triangle_facing;
+  int generation; //Incremented every time a new shape is generated.
+  Polyform_Dirty dirty;
+  void (*transform) (struct Game * const game, const int row, const int col, uint8_t * const state, const int times);
+} Polyiamond;
+extern Polyiamond game_11_polyiamond;
+#define POLYIAMOND_FACING_UP true
+#define POLYIAMOND_FACING_DOWN false
+//Return the direction a triangle is facing for the given (col, row).
+//Either POLYIAMOND_FACING_UP (true) or POLYIAMOND_FACING_DOWN (false).
+//Note that the facing of the top left triangle is required.
+//When using clipped rows and columns make sure to use
+//clipped_first_triangle_facing as the top left triangle facing.
+static inline bool polyiamond_facing(int row, int col, bool top_left_triangle_facing)
+{
+  //We can determine the direction a triangle is facing by knowing the direction
+  //of the top left triangle, which is in polyiamond->first_triangle_direction.
+  //If we know whether the row or column of the triangle we want to check is
+  //even or odd, then we can use this table to determine its direction.
+  //Row  Col  : Direction Facing
+  //Even Even : Same direction as first triangle.
+  //Even Odd  : Opposite.
+  //Odd  Odd  : Same.
+  //Odd  Even : Opposite.
+  bool facing;
+  if(row % 2 == 0)
+  {
+    if(col % 2 == 0)
+    {
+      facing = top_left_triangle_facing;
+    }
+    else
+    {
+      facing = !top_left_triangle_facing;
+    }
+  }
+  else
+  {
+    if(col % 2 == 1)
+    {
+      facing = top_left_triangle_facing;
+    }
+    else
+    {
+      facing = !top_left_triangle_facing;
+    }
+  }
+  return facing;
+}
+
+//Find the triangle a point is in, in constant time. u is how far right the
+//point is of the centre of the top left triangle, in half triangle sides, and
+//v is how far down it is from the top of the grid, in rows. The row and column
+//can be outside the grid.
+static inline void polyiamond_locate(float u, float v, bool top_left_triangle_facing, int * row, int * col)
+{
+  //Triangles c and c + 1 share a slanted edge, and at a height v into the row
+  //the triangle facing up reaches v to either side of its centre while the one
+  //facing down reaches 1 - v. That picks the only triangle the point can be in.
+  int r = (int) floorf(v);
+  int c = (int) floorf(u);
+  v = v - r;
+  //Same as polyiamond_facing, but also right when c is -1.
+  bool facing = ((r + c) & 1) ? !top_left_triangle_facing : top_left_triangle_facing;
+  float reach = (facing == POLYIAMOND_FACING_UP) ? v : 1.0f - v;
+  if(reach < u - c) c++;
+  *row = r;
+  *col = c;
+}
+//Generate a new polyiamond of polyiamond->size triangles.
+void generate_polyiamond(Polyiamond * polyiamond, Pcg32 * rng);
+//Grow or shrink the current polyiamond until it has polyiamond->size
+//triangles, keeping its shape. The states start at 0, ready to be randomized.
+void resize_polyiamond(Polyiamond * polyiamond, Pcg32 * rng);
+void polyiamond_transform(Game * const game, const int row, const int col, uint8_t * const state, const int times);
+void polyiamond_init(Game * game);
+bool matching_polyiamond(const Game * const game, const uint8_t * const left_state, const uint8_t * const right_state);
+void randomize_polyiamond(Game * game);
+
+//Transform the state of one side of a game based on which position the player
+//clicked on. Changes to the game's own sides update game->mismatches.
+void transform(Game * const game, const int position, uint8_t * const state, const int times);
+void triplets_transform(Game * const game, const int position, uint8_t * const state, const int times);
+void sun_transform(Game * const game, const int position, uint8_t * const state, const int times);
+void all_but_one_transform(Game * const game, const int position, uint8_t * const state, const int times);
+
+//Check whether two states match or not.
+bool matching(const uint8_t * const left_state, const uint8_t * const right_state, int number_of_states);
+
+//Randomize the left and right states of a game.
+void randomize(Game * game);
+
+//Randomizing never draws twice. Instead a draw that comes out matching, or
+//the same as before, is patched up, and these count how often that happens.
+typedef struct Randomize_Stats {
+  unsigned long randomizations; //Calls to randomize and the polyform versions.
+  unsigned long extra_clicks; //Draws whose clicks cancelled out.
+  unsigned long repeated_states; //Draws that repeated the old state.
+} Randomize_Stats;
+extern Randomize_Stats randomize_stats;
+
+void standard_init(Game * game);
+
+//The number of states a game currently has, taking growable games into
+//account.
+int game_number_of_states(const Game * const game);
+
+//The number of positions in a game's state arrays. For most games this is the
+//number of states, but polyominoes and polyiamonds use a grid where only some
+//positions hold state data.
+int game_number_of_positions(const Game * const game);
+
+//Check whether a position in a game's state arrays holds state data.
+bool game_position_has_state(const Game * const game, const int position);
+
+//A number that changes whenever the set of positions holding state data
+//changes, for caching things built from a game's shape.
+int game_shape(const Game * const game);
+
+//Count the states that differ between the left and right sides by scanning
+//the whole board.
+int count_mismatches(const Game * const game);
+
+//Check whether the left and right states of a game match, i.e. whether the
+//player has won. This is O(1) since the transforms and randomize keep
+//game->mismatches up to date. Builds with POCICO_CHECK_MISMATCHES defined, like
+//the tests, also check it against a full scan.
+bool matching_game(const Game * const game);
+
+//Change the mod of a game by one and randomize it. Returns false if the mod is
+//already at MAX_MOD or MIN_MOD and nothing changed.
+bool increase_mod(Game * game);
+bool decrease_mod(Game * game);
+
+//Grow or shrink a growable game by one and randomize it. Returns false if the
+//game isn't growable or is already at its maximum or minimum size.
+bool increase_size(Game * game);
+bool decrease_size(Game * game);
+
+//Set the size of a growable game, clamped to its minimum and maximum, and
+//randomize it. Returns false if the size didn't change.
+bool resize_game(Game * game, int number_of_states);
+
+//The growable games keep their states on the heap and grow them on demand, so
+//these only bound how long a randomize or a frame may take.
+#define GROWABLE_TRIPLETS_MAX 1000000
+#define ALL_BUT_ONE_MAX 1000000
+#define SUN_MAX 1000000
+
+#define GAME_10_POLYOMINO_UID 10
+#define GAME_11_POLYIAMOND_UID 11
+
+extern Game game_triforce;
+extern Game game_foursquare;
+extern Game game_squarediamond;
+extern Game game_ammann_beenker;
+extern Game game_trianglehexagon;
+extern Game game_diamondhexagon;
+extern Game game_growabletriplets;
+extern Game game_all_but_one;
+extern Game game_sun;
+extern Game game_polyomino;
+extern Game game_polyiamond;
+
+#define GAME_COUNT 11
+extern Game * games[GAME_COUNT];
+
+//Seed every game's generator. Each game uses its uid as its stream, so the
+//same seed always gives the same puzzles. Call this before init_games.
+void seed_games(const uint64_t seed);
+
+//Call init on every game.
+void init_games(void);
+
+#endif
@@ -0,0 +1,375 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+#include <stddef.h>
+#include "simd.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define POCICO_SIMD_X86
+#include <immintrin.h>
+#endif
+
+//Scalar kernels. These also finish off the tails of the vector kernels.
+
+static bool matching_scalar(const uint8_t * const a, const uint8_t * const b, const int n)
+{
+  for(int i = 0; i < n; i++)
+  {
+    if(a[i] != b[i]) return false;
+  }
+  return true;
+}
+
+static int mismatches_scalar(const uint8_t * const a, const uint8_t * const b, const int n)
+{
+  int mismatches = 0;
+  for(int i = 0; i < n; i++) mismatches += (a[i] != b[i]);
+  return mismatches;
+}
+
+static void add_mod_scalar(uint8_t * const state, const int n, const int times, const int mod)
+{
+  for(int i = 0; i < n; i++) state[i] = add_mod(state[i], times, mod);
+}
+
+//(word * mod) / 2^32 maps a word onto [0, mod) with one multiply, and the
+//low half of the product decides whether it is unbiased. This is Lemire's
+//method: the rare words whose low half is below 2^32 % mod are rejected, and
+//those states are drawn again with pcg32_bounded, so every state is equally
+//likely. With mod at most MAX_MOD that happens about once in 500 million words.
+static inline uint32_t reject_threshold(const int mod)
+{
+  return -(uint32_t)mod % (uint32_t)mod;
+}
+
+static void random_states_scalar(
+  uint8_t * const state,
+  const uint32_t * const random,
+  const uint8_t * const mask,
+  const int n,
+  const int mod,
+  Pcg32 * const rng
+)
+{
+  const uint32_t threshold = reject_threshold(mod);
+  for(int i = 0; i < n; i++)
+  {
+    uint64_t product = (uint64_t)random[i] * (uint32_t)mod;
+    uint8_t value = (uint8_t)(product >> 32);
+    if((uint32_t)product < threshold) value = (uint8_t)pcg32_bounded(rng, mod);
+    state[i] = (mask == NULL) ? value : (value & mask[i]);
+  }
+}
+
+//Redraw the states whose bits are set in rejected, see random_states_scalar.
+static void redraw_states(
+  uint8_t * const state,
+  const uint8_t * const mask,
+  uint32_t rejected,
+  const int mod,
+  Pcg32 * const rng
+)
+{
+  while(rejected != 0)
+  {
+    int i = __builtin_ctz(rejected);
+    rejected &= rejected - 1;
+    uint8_t value = (uint8_t)pcg32_bounded(rng, mod);
+    state[i] = (mask == NULL) ? value : (value & mask[i]);
+  }
+}
+
+#ifdef POCICO_SIMD_X86
+
+__attribute__((target("sse2")))
+static bool matching_sse2(const uint8_t * const a, const uint8_t * const b, const int n)
+{
+  int i = 0;
+  for(; i + 16 <= n; i += 16)
+  {
+    __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+    __m128i y = _mm_loadu_si128((const __m128i *)(b + i));
+    if(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xffff) return false;
+  }
+  return matching_scalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static int mismatches_sse2(const uint8_t * const a, const uint8_t * const b, const int n)
+{
+  //Turn each mismatch into a 1 byte and let sad_epu8 add them up.
+  const __m128i ones = _mm_set1_epi8(1);
+  __m128i count = _mm_setzero_si128();
+  int i = 0;
+  for(; i + 16 <= n; i += 16)
+  {
+    __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+    __m128i y = _mm_loadu_si128((const __m128i *)(b + i));
+    __m128i different = _mm_andnot_si128(_mm_cmpeq_epi8(x, y), ones);
+    count = _mm_add_epi64(count, _mm_sad_epu8(different, _mm_setzero_si128()));
+  }
+  int mismatches = _mm_cvtsi128_si32(count) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(count, count));
+  return mismatches + mismatches_scalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static void add_mod_sse2(uint8_t * const state, const int n, const int times, const int mod)
+{
+  //If sum < mod then sum - mod wraps around past sum, so the unsigned minimum
+  //is the conditional subtract.
+  const __m128i vector_times = _mm_set1_epi8((char)times);
+  const __m128i vector_mod = _mm_set1_epi8((char)mod);
+  int i = 0;
+  for(; i + 16 <= n; i += 16)
+  {
+    __m128i sum = _mm_add_epi8(_mm_loadu_si128((const __m128i *)(state + i)), vector_times);
+    sum = _mm_min_epu8(sum, _mm_sub_epi8(sum, vector_mod));
+    _mm_storeu_si128((__m128i *)(state + i), sum);
+  }
+  add_mod_scalar(state + i, n - i, times, mod);
+}
+
+//Map 4 random words onto [0, mod), and set bit k of *rejected when lane k has
+//to be drawn again. mul_epu32 multiplies the even lanes into 64 bit products,
+//so the odd lanes are shifted down and done separately. The high halves of
+//the products are merged into the values, and the low halves are compared
+//with the threshold. SSE2 only compares signed numbers, so both sides have
+//their top bit flipped first.
+__attribute__((target("sse2")))
+static inline __m128i random_values_sse2(const uint32_t * const random, const __m128i vector_mod, const __m128i flipped_threshold, int * const rejected)
+{
+  const __m128i high_halves = _mm_set_epi32(-1, 0, -1, 0);
+  const __m128i top_bits = _mm_set1_epi32((int)0x80000000);
+  __m128i words = _mm_loadu_si128((const __m128i *)random);
+  __m128i even = _mm_mul_epu32(words, vector_mod);
+  __m128i odd = _mm_mul_epu32(_mm_srli_epi64(words, 32), vector_mod);
+  __m128i lows = _mm_or_si128(_mm_andnot_si128(high_halves, even), _mm_slli_epi64(odd, 32));
+  __m128i reject = _mm_cmplt_epi32(_mm_xor_si128(lows, top_bits), flipped_threshold);
+  *rejected = _mm_movemask_ps(_mm_castsi128_ps(reject));
+  return _mm_or_si128(_mm_srli_epi64(even, 32), _mm_and_si128(odd, high_halves));
+}
+
+__attribute__((target("sse2")))
+static void random_states_sse2(
+  uint8_t * const state,
+  const uint32_t * const random,
+  const uint8_t * const mask,
+  const int n,
+  const int mod,
+  Pcg32 * const rng
+)
+{
+  const __m128i vector_mod = _mm_set1_epi32(mod);
+  const __m128i flipped_threshold = _mm_set1_epi32((int)(reject_threshold(mod) ^ 0x80000000));
+  int i = 0;
+  for(; i + 16 <= n; i += 16)
+  {
+    int rejected[4];
+    __m128i low = _mm_packs_epi32(
+      random_values_sse2(random + i, vector_mod, flipped_threshold, &rejected[0]),
+      random_values_sse2(random + i + 4, vector_mod, flipped_threshold, &rejected[1])
+    );
+    __m128i high = _mm_packs_epi32(
+      random_values_sse2(random + i + 8, vector_mod, flipped_threshold, &rejected[2]),
+      random_values_sse2(random + i + 12, vector_mod, flipped_threshold, &rejected[3])
+    );
+    __m128i values = _mm_packus_epi16(low, high);
+    if(mask != NULL) values = _mm_and_si128(values, _mm_loadu_si128((const __m128i *)(mask + i)));
+    _mm_storeu_si128((__m128i *)(state + i), values);
+    uint32_t all_rejected = rejected[0] | (rejected[1] << 4) | (rejected[2] << 8) | (rejected[3] << 12);
+    if(all_rejected != 0) redraw_states(state + i, (mask == NULL) ? NULL : mask + i, all_rejected, mod, rng);
+  }
+  random_states_scalar(state + i, random + i, (mask == NULL) ? NULL : mask + i, n - i, mod, rng);
+}
+
+__attribute__((target("avx2")))
+static bool matching_avx2(const uint8_t * const a, const uint8_t * const b, const int n)
+{
+  int i = 0;
+  for(; i + 32 <= n; i += 32)
+  {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+    __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+    if(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) != -1) return false;
+  }
+  if(i + 16 <= n)
+  {
+    __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+    __m128i y = _mm_loadu_si128((const __m128i *)(b + i));
+    if(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xffff) return false;
+    i += 16;
+  }
+  return matching_scalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static int mismatches_avx2(const uint8_t * const a, const uint8_t * const b, const int n)
+{
+  const __m256i ones = _mm256_set1_epi8(1);
+  __m256i count = _mm256_setzero_si256();
+  int i = 0;
+  for(; i + 32 <= n; i += 32)
+  {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+    __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+    __m256i different = _mm256_andnot_si256(_mm256_cmpeq_epi8(x, y), ones);
+    count = _mm256_add_epi64(count, _mm256_sad_epu8(different, _mm256_setzero_si256()));
+  }
+  int64_t lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, count);
+  int mismatches = (int)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+  return mismatches + mismatches_scalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void add_mod_avx2(uint8_t * const state, const int n, const int times, const int mod)
+{
+  const __m256i vector_times = _mm256_set1_epi8((char)times);
+  const __m256i vector_mod = _mm256_set1_epi8((char)mod);
+  int i = 0;
+  for(; i + 32 <= n; i += 32)
+  {
+    __m256i sum = _mm256_add_epi8(_mm256_loadu_si256((const __m256i *)(state + i)), vector_times);
+    sum = _mm256_min_epu8(sum, _mm256_sub_epi8(sum, vector_mod));
+    _mm256_storeu_si256((__m256i *)(state + i), sum);
+  }
+  add_mod_scalar(state + i, n - i, times, mod);
+}
+
+//The AVX2 version of random_values_sse2, for 8 words.
+__attribute__((target("avx2")))
+static inline __m256i random_values_avx2(const uint32_t * const random, const __m256i vector_mod, const __m256i flipped_threshold, int * const rejected)
+{
+  const __m256i high_halves = _mm256_set_epi32(-1, 0, -1, 0, -1, 0, -1, 0);
+  const __m256i top_bits = _mm256_set1_epi32((int)0x80000000);
+  __m256i words = _mm256_loadu_si256((const __m256i *)random);
+  __m256i even = _mm256_mul_epu32(words, vector_mod);
+  __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(words, 32), vector_mod);
+  __m256i lows = _mm256_or_si256(_mm256_andnot_si256(high_halves, even), _mm256_slli_epi64(odd, 32));
+  __m256i reject = _mm256_cmpgt_epi32(flipped_threshold, _mm256_xor_si256(lows, top_bits));
+  *rejected = _mm256_movemask_ps(_mm256_castsi256_ps(reject));
+  return _mm256_or_si256(_mm256_srli_epi64(even, 32), _mm256_and_si256(odd, high_halves));
+}
+
+__attribute__((target("avx2")))
+static void random_states_avx2(
+  uint8_t * const state,
+  const uint32_t * const random,
+  const uint8_t * const mask,
+  const int n,
+  const int mod,
+  Pcg32 * const rng
+)
+{
+  //The packs work within each 128 bit half, which leaves the 4 byte groups
+  //interleaved, so a final permute puts them back in order.
+  const __m256i vector_mod = _mm256_set1_epi32(mod);
+  const __m256i flipped_threshold = _mm256_set1_epi32((int)(reject_threshold(mod) ^ 0x80000000));
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  int i = 0;
+  for(; i + 32 <= n; i += 32)
+  {
+    int rejected[4];
+    __m256i low = _mm256_packs_epi32(
+      random_values_avx2(random + i, vector_mod, flipped_threshold, &rejected[0]),
+      random_values_avx2(random + i + 8, vector_mod, flipped_threshold, &rejected[1])
+    );
+    __m256i high = _mm256_packs_epi32(
+      random_values_avx2(random + i + 16, vector_mod, flipped_threshold, &rejected[2]),
+      random_values_avx2(random + i + 24, vector_mod, flipped_threshold, &rejected[3])
+    );
+    __m256i values = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(low, high), order);
+    if(mask != NULL) values = _mm256_and_si256(values, _mm256_loadu_si256((const __m256i *)(mask + i)));
+    _mm256_storeu_si256((__m256i *)(state + i), values);
+    uint32_t all_rejected = (uint32_t)rejected[0] | ((uint32_t)rejected[1] << 8) | ((uint32_t)rejected[2] << 16) | ((uint32_t)rejected[3] << 24);
+    if(all_rejected != 0) redraw_states(state + i, (mask == NULL) ? NULL : mask + i, all_rejected, mod, rng);
+  }
+  random_states_scalar(state + i, random + i, (mask == NULL) ? NULL : mask + i, n - i, mod, rng);
+}
+
+#endif
+
+typedef struct Kernels {
+  const char * name;
+  bool (*matching) (const uint8_t * const a, const uint8_t * const b, const int n);
+  int (*mismatches) (const uint8_t * const a, const uint8_t * const b, const int n);
+  void (*add_mod) (uint8_t * const state, const int n, const int times, const int mod);
+  void (*random_states) (uint8_t * const state, const uint32_t * const random, const uint8_t * const mask, const int n, const int mod, Pcg32 * const rng);
+} Kernels;
+
+static const Kernels scalar_kernels = {"scalar", matching_scalar, mismatches_scalar, add_mod_scalar, random_states_scalar};
+#ifdef POCICO_SIMD_X86
+static const Kernels sse2_kernels = {"sse2", matching_sse2, mismatches_sse2, add_mod_sse2, random_states_sse2};
+static const Kernels avx2_kernels = {"avx2", matching_avx2, mismatches_avx2, add_mod_avx2, random_states_avx2};
+#endif
+
+static const Kernels * kernels = NULL;
+
+static const Kernels * choose_kernels(void)
+{
+  if(kernels != NULL) return kernels;
+  kernels = &scalar_kernels;
+#ifdef POCICO_SIMD_X86
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx2")) kernels = &avx2_kernels;
+  else if(__builtin_cpu_supports("sse2")) kernels = &sse2_kernels;
+#endif
+  return kernels;
+}
+
+//Arrays shorter than one SSE2 register aren't worth an indirect call.
+
+bool simd_matching(const uint8_t * const a, const uint8_t * const b, const int n)
+{
+  if(n < 16) return matching_scalar(a, b, n);
+  return choose_kernels()->matching(a, b, n);
+}
+
+int simd_mismatches(const uint8_t * const a, const uint8_t * const b, const int n)
+{
+  if(n < 16) return mismatches_scalar(a, b, n);
+  return choose_kernels()->mismatches(a, b, n);
+}
+
+void simd_add_mod(uint8_t * const state, const int n, const int times, const int mod)
+{
+  if(n < 16) add_mod_scalar(state, n, times % mod, mod);
+  else choose_kernels()->add_mod(state, n, times % mod, mod);
+}
+
+void simd_random_states(
+  uint8_t * const state,
+  const uint32_t * const random,
+  const uint8_t * const mask,
+  const int n,
+  const int mod,
+  Pcg32 * const rng
+)
+{
+  if(n < 16) random_states_scalar(state, random, mask, n, mod, rng);
+  else choose_kernels()->random_states(state, random, mask, n, mod, rng);
+}
+
+const char * simd_level(void)
+{
+  return choose_kernels()->name;
+}
@@ -0,0 +1,70 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+//Vectorized kernels for the loops over whole state arrays.
+//
+//Each kernel has SSE2 and AVX2 versions and a scalar fallback. The first call
+//picks the best one the CPU supports, and all of them give identical results.
+//States are bytes, so an SSE2 register holds 16 of them and an AVX2 one 32.
+
+#ifndef POCICO_SIMD_H
+#define POCICO_SIMD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pcg.h"
+
+//Add times to a state in [0, mod) with conditional subtracts instead of %.
+//times can be any non negative number, but is normally less than mod.
+static inline int add_mod(int state, const int times, const int mod)
+{
+  state += times;
+  while(state >= mod) state -= mod;
+  return state;
+}
+
+//Check that a[i] == b[i] for every i.
+bool simd_matching(const uint8_t * const a, const uint8_t * const b, const int n);
+
+//Count the positions where a[i] != b[i].
+int simd_mismatches(const uint8_t * const a, const uint8_t * const b, const int n);
+
+//add_mod every entry of state.
+void simd_add_mod(uint8_t * const state, const int n, const int times, const int mod);
+
+//Turn random words into states in [0, mod) without bias. The rare words that
+//would bias a state are rejected, and those states are drawn from rng instead.
+//If mask isn't NULL the states are ANDed with it, so polyforms can keep the
+//positions outside them at 0.
+void simd_random_states(
+  uint8_t * const state,
+  const uint32_t * const random,
+  const uint8_t * const mask,
+  const int n,
+  const int mod,
+  Pcg32 * const rng
+);
+
+//The name of the kernels in use: "avx2", "sse2" or "scalar".
+const char * simd_level(void);
+
+#endif
@@ -0,0 +1,356 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "solver.h"
+#include "bitboard.h"
+
+//Return the inverse of unit mod modulus. The moduli here are at most MAX_MOD,
+//so trying every candidate is as fast as anything cleverer.
+static int inverse_mod(const int unit, const int modulus)
+{
+  for(int i = 1; i < modulus; i++)
+  {
+    if((unit * i) % modulus == 1) return i;
+  }
+  return 0;
+}
+
+//Return the number of factors of prime in value, where value is taken mod
+//modulus = prime^power. Zero has power factors.
+static int valuation(int value, const int prime, const int power)
+{
+  int v = 0;
+  while(v < power && value % prime == 0)
+  {
+    value /= prime;
+    v++;
+  }
+  return v;
+}
+
+//Solve matrix * x = rhs mod prime^power for a size * size matrix in row major
+//order. matrix and rhs are destroyed. Returns false if there is no solution.
+//
+//Every step pivots on the entry of the remaining submatrix with the fewest
+//factors of prime, so every other entry in the pivot row and column is a
+//multiple of the pivot's prime power part and elimination never has to divide
+//by a zero divisor. For power == 1 this is plain Gaussian elimination over Z_p.
+static bool solve_prime_power(
+  int * const matrix,
+  int * const rhs,
+  int * const x,
+  const int size,
+  const int prime,
+  const int power
+)
+{
+  int modulus = 1;
+  for(int i = 0; i < power; i++) modulus *= prime;
+
+  //column_order[c] is the variable currently stored in column c.
+  int * column_order = malloc(sizeof(int) * size);
+  int * pivot_power = malloc(sizeof(int) * size);
+  int * y = malloc(sizeof(int) * size);
+  for(int c = 0; c < size; c++) column_order[c] = c;
+
+  int rank = 0;
+  for(; rank < size; rank++)
+  {
+    //Find the pivot with the lowest valuation.
+    int best_row = -1;
+    int best_col = -1;
+    int best_v = power;
+    for(int r = rank; r < size && best_v > 0; r++)
+    {
+      for(int c = rank; c < size; c++)
+      {
+        int value = matrix[r * size + c];
+        if(value == 0) continue;
+        int v = valuation(value, prime, power);
+        if(v < best_v)
+        {
+          best_v = v;
+          best_row = r;
+          best_col = c;
+          if(v == 0) break;
+        }
+      }
+    }
+    if(best_row < 0) break;
+
+    //Move the pivot to (rank, rank).
+    if(best_row != rank)
+    {
+      for(int c = 0; c < size; c++)
+      {
+        int temp = matrix[rank * size + c];
+        matrix[rank * size + c] = matrix[best_row * size + c];
+        matrix[best_row * size + c] = temp;
+      }
+      int temp = rhs[rank];
+      rhs[rank] = rhs[best_row];
+      rhs[best_row] = temp;
+    }
+    if(best_col != rank)
+    {
+      for(int r = 0; r < size; r++)
+      {
+        int temp = matrix[r * size + rank];
+        matrix[r * size + rank] = matrix[r * size + best_col];
+        matrix[r * size + best_col] = temp;
+      }
+      int temp = column_order[rank];
+      column_order[rank] = column_order[best_col];
+      column_order[best_col] = temp;
+    }
+
+    //pivot = prime^best_v * unit.
+    int scale = 1;
+    for(int i = 0; i < best_v; i++) scale *= prime;
+    int pivot = matrix[rank * size + rank];
+    int unit_inverse = inverse_mod((pivot / scale) % modulus, modulus);
+    pivot_power[rank] = scale;
+
+    //Clear the pivot column below the pivot.
+    for(int r = rank + 1; r < size; r++)
+    {
+      int value = matrix[r * size + rank];
+      if(value == 0) continue;
+      int factor = ((value / scale) * unit_inverse) % modulus;
+      for(int c = rank; c < size; c++)
+      {
+        matrix[r * size + c] = (matrix[r * size + c] + (modulus - factor) * matrix[rank * size + c]) % modulus;
+      }
+      rhs[r] = (rhs[r] + (modulus - factor) * rhs[rank]) % modulus;
+    }
+  }
+
+  bool solvable = true;
+
+  //Rows past the rank are all zero, so their right hand side has to be too.
+  for(int r = rank; r < size; r++)
+  {
+    if(rhs[r] != 0) solvable = false;
+  }
+
+  //Back substitute. Free variables are set to 0.
+  for(int c = rank; c < size; c++) y[c] = 0;
+  for(int r = rank - 1; r >= 0 && solvable; r--)
+  {
+    int sum = rhs[r];
+    for(int c = r + 1; c < rank; c++)
+    {
+      sum = (sum + (modulus - matrix[r * size + c]) * y[c]) % modulus;
+    }
+    //Every entry right of the pivot is a multiple of the pivot's prime power
+    //part, so this row is only solvable if sum is as well.
+    int scale = pivot_power[r];
+    if(sum % scale != 0)
+    {
+      solvable = false;
+      break;
+    }
+    int pivot = matrix[r * size + r];
+    y[r] = ((sum / scale) * inverse_mod((pivot / scale) % modulus, modulus)) % modulus;
+  }
+
+  if(solvable)
+  {
+    for(int c = 0; c < size; c++) x[column_order[c]] = y[c];
+  }
+
+  free(column_order);
+  free(pivot_power);
+  free(y);
+  return solvable;
+}
+
+//The mod 2 case, done on bitboards. left_state and right_state are the
+//game's actual states.
+static bool solve_bitboard(
+  const Bitboard * const board,
+  const Game * const game,
+  const uint8_t * const left_state,
+  const uint8_t * const right_state,
+  int * const times)
+{
+  const int words = board->words;
+  uint64_t left[words];
+  uint64_t right[words];
+  uint64_t clicks[words];
+  bitboard_pack(board, left_state, left);
+  bitboard_pack(board, right_state, right);
+  bool solvable = bitboard_solve(board, left, right, clicks);
+  if(solvable)
+  {
+    const int number_of_positions = game_number_of_positions(game);
+    for(int i = 0; i < number_of_positions; i++) times[i] = 0;
+    for(int bit = 0; bit < board->size; bit++)
+    {
+      times[board->positions[bit]] = (clicks[bit / 64] >> (bit % 64)) & 1;
+    }
+  }
+  return solvable;
+}
+
+bool solve(const Game * const game, int * const times)
+{
+  if(game_number_of_states(game) > SOLVER_MAX_SIZE) return false;
+  const int mod = game->mod;
+  const int number_of_positions = game_number_of_positions(game);
+
+  //Games with offsets don't store their actual states, so work on copies that
+  //have the offsets added in.
+  uint8_t * left_state = malloc(number_of_positions);
+  uint8_t * right_state = malloc(number_of_positions);
+  for(int i = 0; i < number_of_positions; i++)
+  {
+    left_state[i] = game_state(game, game->left_state, i);
+    right_state[i] = game_state(game, game->right_state, i);
+  }
+
+  const Bitboard * board = game_bitboard(game);
+  if(board != NULL)
+  {
+    bool solvable = solve_bitboard(board, game, left_state, right_state, times);
+    free(left_state);
+    free(right_state);
+    return solvable;
+  }
+
+  //Only positions with state data are clickable or matter for the win.
+  int * live = malloc(sizeof(int) * number_of_positions);
+  int size = 0;
+  for(int i = 0; i < number_of_positions; i++)
+  {
+    times[i] = 0;
+    if(game_position_has_state(game, i)) live[size++] = i;
+  }
+
+  //Build the move matrix by clicking each position once on a zeroed copy of
+  //the state. This works for every transform, including the growable and
+  //polyform ones that have no explicit move matrix. Transforms can update the
+  //game they are given, so they get a copy of that too.
+  Game copy = *game;
+  uint8_t * scratch = calloc(number_of_positions, sizeof(uint8_t));
+  int * matrix = malloc(sizeof(int) * size * size);
+  int * rhs = malloc(sizeof(int) * size);
+  int * x = malloc(sizeof(int) * size);
+  int * work_matrix = malloc(sizeof(int) * size * size);
+  int * work_rhs = malloc(sizeof(int) * size);
+  int * work_x = malloc(sizeof(int) * size);
+  for(int c = 0; c < size; c++)
+  {
+    copy.transform(&copy, live[c], scratch, 1);
+    for(int r = 0; r < size; r++)
+    {
+      matrix[r * size + c] = scratch[live[r]];
+      scratch[live[r]] = 0;
+    }
+  }
+  for(int r = 0; r < size; r++)
+  {
+    rhs[r] = (left_state[live[r]] - right_state[live[r]] + mod) % mod;
+    x[r] = 0;
+  }
+
+  //Solve for each prime power dividing mod and glue the answers together with
+  //the chinese remainder theorem. solved_modulus is the product of the prime
+  //powers handled so far.
+  bool solvable = true;
+  int remaining = mod;
+  int solved_modulus = 1;
+  for(int prime = 2; remaining > 1 && solvable; prime++)
+  {
+    if(remaining % prime != 0) continue;
+    int power = 0;
+    int modulus = 1;
+    while(remaining % prime == 0)
+    {
+      remaining /= prime;
+      modulus *= prime;
+      power++;
+    }
+
+    for(int i = 0; i < size * size; i++) work_matrix[i] = matrix[i] % modulus;
+    for(int i = 0; i < size; i++) work_rhs[i] = rhs[i] % modulus;
+    solvable = solve_prime_power(work_matrix, work_rhs, work_x, size, prime, power);
+    if(!solvable) break;
+
+    //x = x (mod solved_modulus) and x = work_x (mod modulus).
+    int inverse = inverse_mod(solved_modulus % modulus, modulus);
+    for(int i = 0; i < size; i++)
+    {
+      int difference = ((work_x[i] - x[i]) % modulus + modulus) % modulus;
+      x[i] += solved_modulus * ((difference * inverse) % modulus);
+    }
+    solved_modulus *= modulus;
+  }
+
+  if(solvable)
+  {
+    for(int i = 0; i < size; i++) times[live[i]] = x[i];
+  }
+
+  free(live);
+  free(left_state);
+  free(right_state);
+  free(scratch);
+  free(matrix);
+  free(rhs);
+  free(x);
+  free(work_matrix);
+  free(work_rhs);
+  free(work_x);
+  return solvable;
+}
+
+bool hint(const Game * const game, int * const position)
+{
+  const int number_of_positions = game_number_of_positions(game);
+  int * times = malloc(sizeof(int) * number_of_positions);
+  bool found = false;
+  if(solve(game, times))
+  {
+    for(int i = 0; i < number_of_positions; i++)
+    {
+      if(times[i] != 0)
+      {
+        *position = i;
+        found = true;
+        break;
+      }
+    }
+  }
+  free(times);
+  return found;
+}
+
+int solution_clicks(const Game * const game, const int * const times)
+{
+  const int number_of_positions = game_number_of_positions(game);
+  int clicks = 0;
+  for(int i = 0; i < number_of_positions; i++) clicks += times[i];
+  return clicks;
+}
@@ -0,0 +1,57 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+//Solve a game by linear algebra instead of searching.
+//
+//Clicking position j adds times[j] to every state the click changes, so a game
+//is the linear system A * times = left_state - right_state over the integers
+//mod game->mod, where column j of A holds the states changed by position j.
+//mod 2 is done on bitboards (see bitboard.h), and any other prime mod is
+//Gaussian elimination over Z_p. A composite mod is split into prime powers
+//with the chinese remainder theorem (6 = 2 * 3), and each prime power (4, 8, 9)
+//is reduced to a Hermite style echelon form by always pivoting on the entry
+//with the fewest factors of p.
+
+#ifndef POCICO_SOLVER_H
+#define POCICO_SOLVER_H
+
+#include <stdbool.h>
+#include "pocico.h"
+
+//Find how many times each position has to be clicked to turn the right state
+//into the left state. times must have room for game_number_of_positions(game)
+//entries, and positions without state data get 0. Each entry is in the range
+//[0, mod). This is one solution, not necessarily the one with the fewest
+//clicks. Returns false if the game has no solution, or if it has more than
+//SOLVER_MAX_SIZE states, since elimination takes time cubic in that and
+//memory quadratic in it.
+#define SOLVER_MAX_SIZE 1024
+bool solve(const Game * const game, int * const times);
+
+//Find a position worth clicking next, i.e. one that appears in a solution.
+//Returns false if the game is already solved or has no solution.
+bool hint(const Game * const game, int * const position);
+
+//The total number of clicks in a solution, e.g. for scoring difficulty.
+int solution_clicks(const Game * const game, const int * const times);
+
+#endif
@@ -0,0 +1,159 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+//For clock_gettime, CLOCK_MONOTONIC and strdup.
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "trace.h"
+
+typedef struct Trace_Event {
+  uint64_t nanoseconds; //Since trace_start.
+  const char * name; //NULL for the end of a zone.
+  int32_t arg;
+  char phase; //'B' or 'E'.
+} Trace_Event;
+
+//Only the thread that owns a buffer writes to it. count is stored with
+//release order after each event, so trace_stop can read the buffers of other
+//threads without locks.
+typedef struct Trace_Buffer {
+  Trace_Event events[TRACE_BUFFER_EVENTS];
+  uint64_t count; //Events recorded, including ones overwritten since.
+  int thread;
+  struct Trace_Buffer * next;
+} Trace_Buffer;
+
+bool trace_enabled = false;
+
+static char * trace_path = NULL;
+static uint64_t trace_epoch = 0;
+//Every thread's buffer, newest first. Threads push onto it with a compare
+//and swap the first time they record.
+static Trace_Buffer * trace_buffers = NULL;
+static int next_trace_thread = 1;
+static _Thread_local Trace_Buffer * trace_buffer = NULL;
+
+static inline uint64_t trace_now(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+void trace_start(const char * const path)
+{
+  free(trace_path);
+  trace_path = strdup(path);
+  if(trace_path == NULL) return;
+  trace_epoch = trace_now();
+  trace_enabled = true;
+}
+
+void trace_record(const char * const name, const char phase, const int32_t arg)
+{
+  Trace_Buffer * buffer = trace_buffer;
+  if(buffer == NULL)
+  {
+    buffer = calloc(1, sizeof(Trace_Buffer));
+    if(buffer == NULL) return;
+    buffer->thread = __atomic_fetch_add(&next_trace_thread, 1, __ATOMIC_RELAXED);
+    buffer->next = __atomic_load_n(&trace_buffers, __ATOMIC_RELAXED);
+    while(!__atomic_compare_exchange_n(&trace_buffers, &buffer->next, buffer, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    trace_buffer = buffer;
+  }
+  uint64_t count = buffer->count;
+  Trace_Event * event = &buffer->events[count & (TRACE_BUFFER_EVENTS - 1)];
+  event->nanoseconds = trace_now() - trace_epoch;
+  event->name = name;
+  event->arg = arg;
+  event->phase = phase;
+  __atomic_store_n(&buffer->count, count + 1, __ATOMIC_RELEASE);
+}
+
+//Write a string as a JSON string.
+static void write_json_string(FILE * file, const char * string)
+{
+  fputc('"', file);
+  for(; *string; string++)
+  {
+    if(*string == '"' || *string == '\\') fputc('\\', file);
+    fputc(*string, file);
+  }
+  fputc('"', file);
+}
+
+void trace_stop(void)
+{
+  if(!trace_enabled) return;
+  trace_enabled = false;
+
+  FILE * file = fopen(trace_path, "w");
+  if(file == NULL)
+  {
+    printf("Warning: could not write trace to %s!\n", trace_path);
+    return;
+  }
+  fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  bool first = true;
+  Trace_Buffer * buffer = __atomic_load_n(&trace_buffers, __ATOMIC_ACQUIRE);
+  for(; buffer != NULL; buffer = buffer->next)
+  {
+    uint64_t count = __atomic_load_n(&buffer->count, __ATOMIC_ACQUIRE);
+    uint64_t start = count > TRACE_BUFFER_EVENTS ? count - TRACE_BUFFER_EVENTS : 0;
+    //When the buffer has wrapped, the first events may end zones whose
+    //beginnings were overwritten. Those are left out.
+    int depth = 0;
+    for(uint64_t i = start; i < count; i++)
+    {
+      const Trace_Event * event = &buffer->events[i & (TRACE_BUFFER_EVENTS - 1)];
+      if(event->phase == 'E')
+      {
+        if(depth == 0) continue;
+        depth--;
+      }
+      else
+      {
+        depth++;
+      }
+      fprintf(file, "%s{\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%.3f", first ? "" : ",\n", event->phase, buffer->thread, event->nanoseconds / 1000.0);
+      if(event->name != NULL)
+      {
+        fprintf(file, ",\"name\":");
+        write_json_string(file, event->name);
+      }
+      if(event->arg != TRACE_NO_ARG)
+      {
+        fprintf(file, ",\"args\":{\"arg\":%d}", (int)event->arg);
+      }
+      fputc('}', file);
+      first = false;
+    }
+  }
+  fprintf(file, "\n]}\n");
+  fclose(file);
+  //The buffers are kept, since their threads still point at them.
+  printf("Wrote trace to %s.\n", trace_path);
+}
@@ -0,0 +1,86 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+//Timeline tracing in Chrome's trace_event JSON format, which Perfetto
+//(https://ui.perfetto.dev) and chrome://tracing can open.
+//
+//Zones are marked with trace_begin and trace_end, or TRACE_SCOPE which ends
+//its zone when the enclosing block exits. Each thread records into its own
+//ring buffer, so recording takes no locks and costs a clock read and a store.
+//When a buffer fills up the oldest events are overwritten. Nothing is recorded
+//until trace_start is called, and trace_stop writes the file.
+
+#ifndef POCICO_TRACE_H
+#define POCICO_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//Events kept per thread.
+#define TRACE_BUFFER_EVENTS (1 << 16)
+//Passed as arg when an event has none.
+#define TRACE_NO_ARG INT32_MIN
+
+extern bool trace_enabled;
+
+//Start recording. The trace will be written to path by trace_stop.
+void trace_start(const char * const path);
+
+//Write everything recorded so far to the file given to trace_start and stop
+//recording. Call it once the other threads have stopped tracing.
+void trace_stop(void);
+
+//Record an event. name has to outlive the trace, e.g. a string literal.
+void trace_record(const char * const name, const char phase, const int32_t arg);
+
+//Begin and end a zone. Zones on the same thread have to nest.
+static inline void trace_begin(const char * const name)
+{
+  if(trace_enabled) trace_record(name, 'B', TRACE_NO_ARG);
+}
+
+//Begin a zone and attach a number to it, like which game it is for.
+static inline void trace_begin_arg(const char * const name, const int32_t arg)
+{
+  if(trace_enabled) trace_record(name, 'B', arg);
+}
+
+static inline void trace_end(void)
+{
+  if(trace_enabled) trace_record(NULL, 'E', TRACE_NO_ARG);
+}
+
+static inline void trace_scope_end(const char * const * name)
+{
+  (void)name;
+  trace_end();
+}
+
+//Trace the rest of the enclosing block as a zone.
+#define TRACE_SCOPE_NAME(line) trace_scope_ ## line
+#define TRACE_SCOPE_LINE(name, line) \
+  const char * TRACE_SCOPE_NAME(line) __attribute__((cleanup(trace_scope_end), unused)) = name; \
+  trace_begin(TRACE_SCOPE_NAME(line))
+#define TRACE_SCOPE_EXPAND(name, line) TRACE_SCOPE_LINE(name, line)
+#define TRACE_SCOPE(name) TRACE_SCOPE_EXPAND(name, __LINE__)
+
+#endif
@@ -0,0 +1,44 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+//A check macro for the engine tests. Each test is a program whose main returns
+//check_failures, so make check stops at the first test with a failed check.
+
+#ifndef POCICO_CHECK_H
+#define POCICO_CHECK_H
+
+#include <stdio.h>
+
+static int check_failures = 0;
+
+//Count and print a failed check, but keep going so one run shows them all.
+//Only the first few are printed, since a broken kernel fails on every input.
+#define CHECK(condition) \
+  do \
+  { \
+    if(!(condition)) \
+    { \
+      if(check_failures++ < 20) fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+    } \
+  } while(0)
+
+#endif
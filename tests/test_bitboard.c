@@ -0,0 +1,132 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+//Check the mod 2 bitboards against the byte versions they stand in for. Every
+//click on a packed board has to flip exactly the states game->transform
+//changes, the packed win check has to agree with matching_game, and the
+//clicks bitboard_solve finds have to win the byte board.
+
+#include <stdlib.h>
+#include "check.h"
+#include "bitboard.h"
+#include "pocico.h"
+
+//The bits past board->size in the last word have to stay 0, or the packed
+//compares would see differences that aren't there.
+static bool padding_clear(const Bitboard * const board, const uint64_t * const bits)
+{
+  int used = board->size % 64;
+  return used == 0 || (bits[board->words - 1] >> used) == 0;
+}
+
+static void check_board(Game * game)
+{
+  settle_offsets(game);
+  game->mod = 2;
+  game->randomize(game);
+
+  Bitboard board;
+  CHECK(bitboard_init(&board, game));
+  const int words = board.words;
+  uint64_t * left = malloc(sizeof(uint64_t) * words);
+  uint64_t * right = malloc(sizeof(uint64_t) * words);
+  uint64_t * clicks = malloc(sizeof(uint64_t) * words);
+  int positions = game_number_of_positions(game);
+  uint8_t * unpacked = calloc(positions, 1);
+
+  //Packing and unpacking gives back the same states.
+  settle_offsets(game);
+  bitboard_pack(&board, game->left_state, left);
+  bitboard_unpack(&board, left, unpacked);
+  for(int bit = 0; bit < board.size; bit++)
+  {
+    int p = board.positions[bit];
+    CHECK(game_position_has_state(game, p));
+    CHECK(unpacked[p] == game->left_state[p]);
+  }
+
+  //Each click flips what the byte transform changes.
+  for(int i = 0; i < 200; i++)
+  {
+    int bit = pcg32_bounded(&game->rng, board.size);
+    settle_offsets(game);
+    bitboard_pack(&board, game->right_state, right);
+    bitboard_click(&board, right, bit);
+    game->transform(game, board.positions[bit], game->right_state, 1);
+    settle_offsets(game);
+    bitboard_pack(&board, game->right_state, clicks);
+    CHECK(bitboard_matching(&board, right, clicks));
+    CHECK(padding_clear(&board, right));
+    bitboard_pack(&board, game->left_state, left);
+    CHECK(bitboard_matching(&board, left, right) == matching_game(game));
+  }
+
+  //Random boards and scrambles keep the padding clear.
+  bitboard_random(&board, &game->rng, left);
+  CHECK(padding_clear(&board, left));
+  bitboard_scramble(&board, &game->rng, left);
+  CHECK(padding_clear(&board, left));
+
+  //The solution wins both the packed board and the byte one.
+  settle_offsets(game);
+  bitboard_pack(&board, game->left_state, left);
+  bitboard_pack(&board, game->right_state, right);
+  CHECK(bitboard_solve(&board, left, right, clicks));
+  for(int bit = 0; bit < board.size; bit++)
+  {
+    if((clicks[bit / 64] >> (bit % 64)) & 1)
+    {
+      bitboard_click(&board, right, bit);
+      game->transform(game, board.positions[bit], game->right_state, 1);
+    }
+  }
+  CHECK(bitboard_matching(&board, left, right));
+  CHECK(matching_game(game));
+
+  free(left);
+  free(right);
+  free(clicks);
+  free(unpacked);
+  bitboard_free(&board);
+}
+
+int main(void)
+{
+  seed_games(1);
+  init_games();
+  for(int g = 0; g < GAME_COUNT; g++)
+  {
+    Game * game = games[g];
+    //Sizes on both sides of a word boundary for the growable games.
+    int sizes = game->growable ? 8 : 1;
+    for(int s = 0; s < sizes; s++)
+    {
+      if(game->growable) resize_game(game, game->growable_data.min_number_of_states + 19 * s);
+      for(int run = 0; run < 10; run++)
+      {
+        check_board(game);
+      }
+    }
+  }
+  printf("bitboard: %d failed checks\n", check_failures);
+  return check_failures;
+}
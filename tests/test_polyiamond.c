@@ -0,0 +1,108 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+//Check polyiamond_locate, which inverts a click into a triangle in constant
+//time, against testing the point against the triangles themselves. In the
+//units polyiamond_locate takes, triangle (r, c) facing up has its top at
+//(c, r) and its base from (c - 1, r + 1) to (c + 1, r + 1). One facing down
+//has its top edge from (c - 1, r) to (c + 1, r) and its bottom at (c, r + 1).
+
+#include "check.h"
+#include "pocico.h"
+
+#define POINTS 400000
+#define ROWS 20
+#define COLS 40
+
+//Twice the signed area of (a, b, p), positive when p is left of a to b.
+static double side(double ax, double ay, double bx, double by, double px, double py)
+{
+  return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+}
+
+//Whether (u, v) is strictly inside triangle (r, c), and not too close to an
+//edge for floats to tell which side it is on.
+static bool in_triangle(double u, double v, int r, int c, bool facing, bool * near_edge)
+{
+  double x[3];
+  double y[3];
+  if(facing == POLYIAMOND_FACING_UP)
+  {
+    x[0] = c; y[0] = r;
+    x[1] = c - 1; y[1] = r + 1;
+    x[2] = c + 1; y[2] = r + 1;
+  }
+  else
+  {
+    x[0] = c - 1; y[0] = r;
+    x[1] = c; y[1] = r + 1;
+    x[2] = c + 1; y[2] = r;
+  }
+  double s0 = side(x[0], y[0], x[1], y[1], u, v);
+  double s1 = side(x[1], y[1], x[2], y[2], u, v);
+  double s2 = side(x[2], y[2], x[0], y[0], u, v);
+  bool inside = (s0 > 0 && s1 > 0 && s2 > 0) || (s0 < 0 && s1 < 0 && s2 < 0);
+  if(inside && (fabs(s0) < 1e-4 || fabs(s1) < 1e-4 || fabs(s2) < 1e-4)) *near_edge = true;
+  return inside;
+}
+
+int main(void)
+{
+  Pcg32 rng;
+  pcg32_seed(&rng, 1, 1);
+  int checked = 0;
+  for(int f = 0; f < 2; f++)
+  {
+    bool first_facing = (f == 0) ? POLYIAMOND_FACING_UP : POLYIAMOND_FACING_DOWN;
+    for(int i = 0; i < POINTS / 2; i++)
+    {
+      float u = (pcg32_random(&rng) / 4294967296.0) * COLS;
+      float v = (pcg32_random(&rng) / 4294967296.0) * ROWS;
+
+      //Find the triangle by testing every one nearby.
+      int found_r = -1;
+      int found_c = -1;
+      int found = 0;
+      bool near_edge = false;
+      int r0 = (int) floorf(v);
+      for(int c = (int) floorf(u) - 2; c <= (int) floorf(u) + 2; c++)
+      {
+        if(in_triangle(u, v, r0, c, polyiamond_facing(r0, c < 0 ? c + 2 : c, first_facing), &near_edge))
+        {
+          found_r = r0;
+          found_c = c;
+          found++;
+        }
+      }
+      //Points on or next to an edge could go either way.
+      if(near_edge || found == 0) continue;
+
+      int r, c;
+      polyiamond_locate(u, v, first_facing, &r, &c);
+      CHECK(found == 1);
+      CHECK(r == found_r && c == found_c);
+      checked++;
+    }
+  }
+  printf("polyiamond: %d points, %d failed checks\n", checked, check_failures);
+  return check_failures;
+}
@@ -0,0 +1,113 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+//Check every SIMD kernel the CPU supports against the scalar one, over lengths
+//that leave every possible tail, and the scalar kernels against plain loops.
+//simd.c is included so the test can reach each set of kernels, not just the
+//one simd_level picked.
+
+#include <stdlib.h>
+#include <string.h>
+#include "check.h"
+#include "pocico.h"
+#include "simd.c"
+
+#define MAX_LENGTH 4099
+
+static uint8_t a[MAX_LENGTH];
+static uint8_t b[MAX_LENGTH];
+static uint8_t mask[MAX_LENGTH];
+static uint8_t expected[MAX_LENGTH];
+static uint8_t actual[MAX_LENGTH];
+static uint32_t words[MAX_LENGTH];
+
+static void check_kernels(const Kernels * const k, Pcg32 * rng, const int n, const int mod)
+{
+  for(int i = 0; i < n; i++)
+  {
+    a[i] = pcg32_bounded(rng, mod);
+    //Mostly equal, so matching has to look all the way to the end.
+    b[i] = (pcg32_bounded(rng, 64) == 0) ? pcg32_bounded(rng, mod) : a[i];
+    mask[i] = pcg32_bounded(rng, 2) ? 0xff : 0;
+    //Word 0 is rejected by Lemire's method for every mod that isn't a power
+    //of 2, so put some in to exercise the redraws.
+    words[i] = (pcg32_bounded(rng, 16) == 0) ? 0 : pcg32_random(rng);
+  }
+
+  int mismatches = 0;
+  for(int i = 0; i < n; i++) mismatches += (a[i] != b[i]);
+  CHECK(k->matching(a, b, n) == (mismatches == 0));
+  CHECK(k->matching(a, a, n));
+  CHECK(k->mismatches(a, b, n) == mismatches);
+
+  int times = pcg32_bounded(rng, mod);
+  for(int i = 0; i < n; i++) expected[i] = (a[i] + times) % mod;
+  memcpy(actual, a, n);
+  k->add_mod(actual, n, times, mod);
+  CHECK(memcmp(actual, expected, n) == 0);
+
+  for(int masked = 0; masked < 2; masked++)
+  {
+    //Both kernels redraw from copies of the same generator, and have to
+    //consume it the same way.
+    Pcg32 scalar_rng = *rng;
+    Pcg32 kernel_rng = *rng;
+    random_states_scalar(expected, words, masked ? mask : NULL, n, mod, &scalar_rng);
+    k->random_states(actual, words, masked ? mask : NULL, n, mod, &kernel_rng);
+    CHECK(memcmp(actual, expected, n) == 0);
+    CHECK(scalar_rng.state == kernel_rng.state);
+    for(int i = 0; i < n; i++)
+    {
+      CHECK(expected[i] < mod);
+      if(masked && mask[i] == 0) CHECK(expected[i] == 0);
+    }
+  }
+}
+
+int main(void)
+{
+  const Kernels * all[3] = {&scalar_kernels, NULL, NULL};
+#ifdef POCICO_SIMD_X86
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("sse2")) all[1] = &sse2_kernels;
+  if(__builtin_cpu_supports("avx2")) all[2] = &avx2_kernels;
+#endif
+
+  Pcg32 rng;
+  pcg32_seed(&rng, 1, 1);
+  for(int k = 0; k < 3; k++)
+  {
+    if(all[k] == NULL)
+    {
+      printf("simd: %s isn't supported here, skipping it\n", k == 1 ? "sse2" : "avx2");
+      continue;
+    }
+    for(int mod = MIN_MOD; mod <= MAX_MOD; mod++)
+    {
+      for(int n = 0; n <= 200; n++) check_kernels(all[k], &rng, n, mod);
+      check_kernels(all[k], &rng, 1001, mod);
+      check_kernels(all[k], &rng, MAX_LENGTH, mod);
+    }
+  }
+  printf("simd: %d failed checks\n", check_failures);
+  return check_failures;
+}
@@ -0,0 +1,84 @@
+/*
+pocico is a game about changing states.
+Copyright (C) 2018 Manik Sinha
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+Official website: https://manik-sinha.itch.io/pocico
+Official repository: https://github.com/Manik-Sinha/pocico
+Official email: ManikSinha@protonmail.com
+*/
+
+//Check that solve finds clicks that win every game at every mod. Each board is
+//randomized, solved, and the clicks are applied to it. Composite mods go
+//through the prime power and CRT paths of the solver, and mod 2 through the
+//bitboard one.
+
+#include <stdlib.h>
+#include "check.h"
+#include "pocico.h"
+#include "solver.h"
+
+//Randomize a board of the game at this mod, then solve it and play the
+//solution.
+static void check_solve(Game * game, const int mod)
+{
+  settle_offsets(game);
+  game->mod = mod;
+  game->randomize(game);
+  CHECK(!matching_game(game));
+
+  int positions = game_number_of_positions(game);
+  int * times = malloc(sizeof(int) * positions);
+  bool solved = solve(game, times);
+  CHECK(solved);
+  if(solved)
+  {
+    for(int p = 0; p < positions; p++)
+    {
+      CHECK(0 <= times[p] && times[p] < mod);
+      CHECK(times[p] == 0 || game_position_has_state(game, p));
+      if(times[p] > 0) game->transform(game, p, game->right_state, times[p]);
+    }
+    CHECK(matching_game(game));
+    CHECK(count_mismatches(game) == 0);
+  }
+  free(times);
+}
+
+int main(void)
+{
+  seed_games(1);
+  init_games();
+  for(int g = 0; g < GAME_COUNT; g++)
+  {
+    Game * game = games[g];
+    //Growable games are checked at several sizes, which gives the polyforms
+    //several shapes too.
+    int sizes = game->growable ? 6 : 1;
+    for(int s = 0; s < sizes; s++)
+    {
+      if(game->growable) resize_game(game, game->growable_data.min_number_of_states + 7 * s);
+      for(int mod = MIN_MOD; mod <= MAX_MOD; mod++)
+      {
+        for(int run = 0; run < 20; run++)
+        {
+          check_solve(game, mod);
+        }
+      }
+    }
+  }
+  printf("solver: %d failed checks\n", check_failures);
+  return check_failures;
+}